@@ -0,0 +1,130 @@
+#include "battery.h"
+#include <avr/io.h>
+#include <avr/interrupt.h>
+
+// Battery sense pin: pack+ through a 47k/10k divider (24V pack -> ~4.2V)
+static const uint8_t BATTERY_PIN = A0;       // ADC0 - Battery voltage divider tap
+
+// ADC counts to millivolts in Q8: 5000mV / 1023 * (47k + 10k) / 10k = 27.859 mV/count
+static const uint32_t BATTERY_MV_PER_COUNT_Q8 = 7132;
+
+// Feed-forward reference: max_throttle means the same motor voltage as 254 at this pack voltage
+static const uint16_t BATTERY_NOMINAL_MV = 22000;
+
+// Low-voltage derate: full drive target above DERATE_START, linear down to 0 at CUTOFF.
+// The cutoff latches until the pack recovers above CUTOFF + HYSTERESIS (unloaded sag recovery).
+static const uint16_t BATTERY_DERATE_START_MV = 21000;
+static const uint16_t BATTERY_CUTOFF_MV = 19500;
+static const uint16_t BATTERY_CUTOFF_HYSTERESIS_MV = 300;
+
+// Below this the divider is not fitted (pin reads ~0V): bypass compensation
+static const uint16_t BATTERY_PRESENT_MV = 5000;
+
+// Samples per published value (~1kHz Timer0 trigger -> ~15 updates per second)
+static const uint8_t BATTERY_PUBLISH_SAMPLES = 64;
+
+// IIR filter state (ADC counts in Q16, time constant 256 samples ~0.26s)
+static int32_t battery_filt_q16 = 0;
+static bool battery_seeded = false;
+static uint8_t battery_sample_count = 0;
+
+// Published filtered value (ADC counts in Q6, written by ISR, read by API)
+volatile uint16_t battery_adc_q6 = 0;
+volatile bool battery_new_sample = false;
+
+// Derived values, recomputed only when a new filtered sample is published
+static uint16_t battery_mv = 0;
+static uint16_t battery_scale_q8 = 256;
+static int16_t battery_limit = 254;
+static bool battery_cut_off = false;
+
+// ADC conversion complete ISR (auto-triggered by Timer0 overflow)
+ISR(ADC_vect) {
+  int32_t sample_q16 = (int32_t)ADC << 16;
+  if (!battery_seeded) {                // start from first reading, not from 0V
+    battery_filt_q16 = sample_q16;
+    battery_seeded = true;
+  }
+  battery_filt_q16 += (sample_q16 - battery_filt_q16) >> 8;
+
+  if (++battery_sample_count >= BATTERY_PUBLISH_SAMPLES) {
+    battery_sample_count = 0;
+    battery_adc_q6 = (uint16_t)(battery_filt_q16 >> 10);
+    battery_new_sample = true;
+  }
+}
+
+void setup_battery() {
+  pinMode(BATTERY_PIN, INPUT);
+  DIDR0 |= _BV(ADC0D);                  // Disable digital input buffer on ADC0
+
+  // AVcc reference, right adjusted, channel ADC0
+  ADMUX = _BV(REFS0);
+  ADCSRB = _BV(ADTS2);                  // Auto trigger source: Timer0 overflow (~976Hz)
+
+  // Enable ADC, auto trigger, interrupt, prescaler 128 (125kHz ADC clock)
+  ADCSRA = _BV(ADEN) | _BV(ADATE) | _BV(ADIE) | _BV(ADIF) |
+           _BV(ADPS2) | _BV(ADPS1) | _BV(ADPS0);
+}
+
+// Recompute millivolts and feed-forward scale from the latest filtered sample
+static void update_battery() {
+  if (!battery_new_sample) return;
+
+  noInterrupts();
+  uint16_t adc_q6 = battery_adc_q6;
+  battery_new_sample = false;
+  interrupts();
+
+  battery_mv = (uint16_t)(((uint32_t)adc_q6 * BATTERY_MV_PER_COUNT_Q8) >> 14);
+
+  if (battery_mv < BATTERY_PRESENT_MV) {
+    battery_scale_q8 = 256;             // No divider fitted, raw duty as before
+    battery_limit = 254;
+    battery_cut_off = false;
+    return;
+  }
+  battery_scale_q8 = (uint16_t)(((uint32_t)BATTERY_NOMINAL_MV << 8) / battery_mv);
+
+  if (battery_mv <= BATTERY_CUTOFF_MV) {
+    battery_cut_off = true;             // Pack exhausted, stop driving
+  } else if (battery_mv >= BATTERY_CUTOFF_MV + BATTERY_CUTOFF_HYSTERESIS_MV) {
+    battery_cut_off = false;
+  }
+
+  if (battery_cut_off) {
+    battery_limit = 0;
+  } else if (battery_mv < BATTERY_DERATE_START_MV) {
+    battery_limit = (int16_t)(254UL * (battery_mv - BATTERY_CUTOFF_MV) /
+                              (BATTERY_DERATE_START_MV - BATTERY_CUTOFF_MV));
+  } else {
+    battery_limit = 254;
+  }
+}
+
+uint16_t get_battery_mv() {
+  update_battery();
+  return battery_mv;
+}
+
+uint16_t get_battery_scale() {
+  update_battery();
+  return battery_scale_q8;
+}
+
+int16_t get_battery_limit() {
+  update_battery();
+  return battery_limit;
+}
+
+int16_t compensate_battery(int16_t speed) {
+  update_battery();
+
+  // Scale the magnitude so forward and reverse round the same way
+  uint16_t magnitude = speed < 0 ? -speed : speed;
+  uint32_t scaled = ((uint32_t)magnitude * battery_scale_q8) >> 8;
+
+  // Clamp to 254 max - driver doesn't handle 255 correctly
+  if (scaled > 254) scaled = 254;
+  return speed < 0 ? -(int16_t)scaled : (int16_t)scaled;
+}
@@ -0,0 +1,22 @@
+#ifndef BATTERY_H
+#define BATTERY_H
+
+#include <Arduino.h>
+
+// Initialize interrupt-driven battery voltage sampling (ADC0, pin A0)
+void setup_battery();
+
+// Filtered battery voltage in millivolts (0 if no sample yet)
+uint16_t get_battery_mv();
+
+// Current feed-forward scale applied to drive duty (256 = 1.0)
+uint16_t get_battery_scale();
+
+// Max drive target (0-254) allowed by the low-voltage derate/cutoff, applied before the ramp
+int16_t get_battery_limit();
+
+// Scale a signed drive duty so it yields the same effective motor voltage
+// regardless of pack charge (feed-forward only, applied after the ramp)
+int16_t compensate_battery(int16_t speed);
+
+#endif // BATTERY_H
@@ -1,7 +1,13 @@
 #include "debug.h"
 #include "receiver.h"
 #include "motors.h"
+#include "battery.h"
+#include "thermal.h"
+#include "warmboot.h"
+#include "params.h"
+#include "power.h"
 #include "main.h"
+#include "onboard.h"
 #include "version.h"
 #include <avr/io.h>
 
@@ -19,7 +25,13 @@ static struct {
   uint8_t ch5 : 1;
   uint8_t ch6 : 1;
   uint8_t ch7 : 1;
-} debug_flags = {0, 0, 0, 0, 0, 0, 0, 0};
+  uint8_t battery : 1;
+  uint8_t thermal : 1;
+  uint8_t onboard : 1;
+  uint8_t link : 1;
+  uint8_t passes : 1;
+  uint8_t power : 1;
+} debug_flags = {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0};
 
 // Master pause flag
 static bool debug_paused = false;
@@ -42,6 +54,60 @@ void setup_debug() {
 }
 
 
+// Fixed-width control mode name
+static const char* control_mode_name(uint8_t mode) {
+  switch (mode) {
+    case WAIT_TX: return "WAIT_TX";
+    case ARMING_REMOTE_CONTROL: return "ARM_RC ";
+    case ARMING_KID_CONTROL: return "ARM_KID";
+    case SWITCHING_TO_REMOTE_CONTROL: return "SW_RC  ";
+    case SWITCHING_TO_KID_CONTROL: return "SW_KID ";
+    case REMOTE_CONTROL: return "RC     ";
+    case KID_CONTROL: return "KID    ";
+  }
+  return "UNKNOWN";
+}
+
+void print_reset_info() {
+  static const char* const cause_names[RESET_CAUSE_COUNT] = {
+    "power-on", "external", "brown-out", "watchdog", "jtag"
+  };
+  const ResetInfo& info = get_reset_info();
+  char buf[64];
+
+  Serial.print(F("Last reset: "));
+  Serial.print(cause_names[info.cause]);
+  Serial.println(info.warm ? F(" (warm boot)") : F(" (cold boot)"));
+  sprintf(buf, "Before reset: mode=%s speed=%d uptime=%lums",
+          control_mode_name(info.prev_mode), info.prev_speed, info.prev_uptime_ms);
+  Serial.println(buf);
+  Serial.print(F("Resets since power-on:"));
+  for (uint8_t i = 0; i < RESET_CAUSE_COUNT; i++) {
+    sprintf(buf, " %s=%u", cause_names[i], info.counts[i]);
+    Serial.print(buf);
+  }
+  Serial.println();
+}
+
+void print_receiver_stats() {
+  static const char* const channel_names[RX_CHANNEL_COUNT] = {
+    "1:STEER", "3:THROT", "5:REV  ", "6:MAXTH", "7:TAKEO"
+  };
+  char buf[112];
+  unsigned long now = millis();
+
+  for (uint8_t i = 0; i < RX_CHANNEL_COUNT; i++) {
+    ReceiverStats stats;
+    get_receiver_stats(i, stats);
+    sprintf(buf, "%s frames=%lu period=%5uus jitter=%u.%uus oor=%u drop=%u gap=%ums last=%lums",
+            channel_names[i], stats.frames, stats.period_us,
+            stats.jitter_q4 >> 4, ((stats.jitter_q4 & 0x0F) * 10) >> 4,
+            stats.out_of_range, stats.dropouts, stats.longest_gap_ms,
+            stats.frames ? now - stats.last_edge_ms : 0);
+    Serial.println(buf);
+  }
+}
+
 void print_help() {
   Serial.print(FPSTR(MOSTERRAK_LOGO));
   Serial.println(FPSTR(VERSION_INFO_STR));
@@ -56,6 +122,19 @@ void print_help() {
     "5 - Toggle CH5 (reverse) receiver info\n"
     "6 - Toggle CH6 (max throttle) receiver info\n"
     "7 - Toggle CH7 (takeover) receiver info\n"
+    "b - Toggle battery info (voltage, feed-forward scale, drive limit)\n"
+    "d - Toggle driver thermal info (budget used, drive limit)\n"
+    "k - Toggle onboard kid controls (debounced pedals, speed switch)\n"
+    "l - Toggle receiver link health summary (total drops/out of range, worst gap/jitter)\n"
+    "p - Toggle control loop passes (recomputed vs. skipped)\n"
+    "z - Toggle parked mode info (sleep share, wake-to-control latency)\n"
+    "i - Show per-channel receiver link statistics\n"
+    "x - Clear receiver link statistics\n"
+    "r - Show last reset cause and reset counters\n"
+    ":list - Show tuning profiles and active parameters\n"
+    ":get <param> / :set <param> <value> - Read/change a parameter live\n"
+    ":profile <n|name> - Switch tuning profile\n"
+    ":save - Store profiles in EEPROM, :defaults - Factory profiles\n"
     "SPACE - Pause/resume debug output\n"
     "h - Show this help\n"
   ));
@@ -65,6 +144,8 @@ void process_debug_input() {
   if (!Serial.available()) return;
   
   char cmd = Serial.read();
+  if (params_input(cmd)) return;  // Part of a ':' tuning command line
+  
   switch (cmd) {
     case 'c': debug_flags.control_mode = !debug_flags.control_mode; break;
     case 't': debug_flags.throttle = !debug_flags.throttle; break;
@@ -74,6 +155,15 @@ void process_debug_input() {
     case '5': debug_flags.ch5 = !debug_flags.ch5; break;
     case '6': debug_flags.ch6 = !debug_flags.ch6; break;
     case '7': debug_flags.ch7 = !debug_flags.ch7; break;
+    case 'b': debug_flags.battery = !debug_flags.battery; break;
+    case 'd': debug_flags.thermal = !debug_flags.thermal; break;
+    case 'k': debug_flags.onboard = !debug_flags.onboard; break;
+    case 'l': debug_flags.link = !debug_flags.link; break;
+    case 'p': debug_flags.passes = !debug_flags.passes; break;
+    case 'z': debug_flags.power = !debug_flags.power; break;
+    case 'i': print_receiver_stats(); break;
+    case 'x': reset_receiver_stats(); break;
+    case 'r': print_reset_info(); break;
     case ' ': debug_paused = !debug_paused; break;
     case 'h':
     case 'H':
@@ -96,27 +186,19 @@ void print_debug_status() {
   // Check if any debug output is enabled
   if (!debug_flags.control_mode && !debug_flags.throttle && !debug_flags.steering &&
       !debug_flags.ch1 && !debug_flags.ch3 && !debug_flags.ch5 && 
-      !debug_flags.ch6 && !debug_flags.ch7) {
+      !debug_flags.ch6 && !debug_flags.ch7 && !debug_flags.battery &&
+      !debug_flags.thermal && !debug_flags.onboard &&
+      !debug_flags.link && !debug_flags.passes && !debug_flags.power) {
     return;
   }
   
-  char buf[40];  // Reusable small buffer
+  char buf[64];  // Reusable small buffer
   bool need_separator = false;
   
   // Control mode
   if (debug_flags.control_mode) {
-    const char* mode_str = "UNKNOWN";
-    switch (control_mode) {
-      case WAIT_TX: mode_str = "WAIT_TX"; break;
-      case ARMING_REMOTE_CONTROL: mode_str = "ARM_RC "; break;
-      case ARMING_KID_CONTROL: mode_str = "ARM_KID"; break;
-      case SWITCHING_TO_REMOTE_CONTROL: mode_str = "SW_RC  "; break;
-      case SWITCHING_TO_KID_CONTROL: mode_str = "SW_KID "; break;
-      case REMOTE_CONTROL: mode_str = "RC     "; break;
-      case KID_CONTROL: mode_str = "KID    "; break;
-    }
     Serial.print(F("C:"));
-    Serial.print(mode_str);
+    Serial.print(control_mode_name(control_mode));
     need_separator = true;
   }
   
@@ -146,6 +228,77 @@ void print_debug_status() {
     need_separator = true;
   }
   
+  // Battery info
+  if (debug_flags.battery) {
+    if (need_separator) Serial.print(F(" | "));
+    uint16_t scale_pct = ((uint32_t)get_battery_scale() * 100) >> 8;
+    sprintf(buf, "B:%5umV ff=%3u%% lim=%3d", get_battery_mv(), scale_pct, get_battery_limit());
+    Serial.print(buf);
+    need_separator = true;
+  }
+  
+  // Driver thermal info
+  if (debug_flags.thermal) {
+    if (need_separator) Serial.print(F(" | "));
+    uint16_t heat_pct = ((uint32_t)get_thermal_level() * 100) >> 8;
+    sprintf(buf, "D:heat=%3u%% lim=%3u", heat_pct, get_thermal_limit());
+    Serial.print(buf);
+    need_separator = true;
+  }
+  
+  // Onboard kid controls
+  if (debug_flags.onboard) {
+    if (need_separator) Serial.print(F(" | "));
+    sprintf(buf, "K:F%d R%d L%d", get_fwd_pedal(), get_rev_pedal(), get_speed_low());
+    Serial.print(buf);
+    need_separator = true;
+  }
+  
+  // Receiver link health: dropouts and out of range pulses summed, gap and jitter worst across channels
+  if (debug_flags.link) {
+    if (need_separator) Serial.print(F(" | "));
+    uint16_t dropouts = 0, gap = 0, oor = 0, jitter_q4 = 0;
+    for (uint8_t i = 0; i < RX_CHANNEL_COUNT; i++) {
+      ReceiverStats stats;
+      get_receiver_stats(i, stats);
+      dropouts += stats.dropouts;
+      oor += stats.out_of_range;
+      if (stats.longest_gap_ms > gap) gap = stats.longest_gap_ms;
+      if (stats.jitter_q4 > jitter_q4) jitter_q4 = stats.jitter_q4;
+    }
+    sprintf(buf, "L:tot drop=%u oor=%u max gap=%ums jit=%uus", dropouts, oor, gap, (jitter_q4 + 8) >> 4);
+    Serial.print(buf);
+    need_separator = true;
+  }
+  
+  // Control loop passes, skipped share over the last print interval
+  if (debug_flags.passes) {
+    static unsigned long last_run = 0, last_skipped = 0;
+    if (need_separator) Serial.print(F(" | "));
+    unsigned long run = control_passes_run - last_run;
+    unsigned long skipped = control_passes_skipped - last_skipped;
+    last_run = control_passes_run;
+    last_skipped = control_passes_skipped;
+    unsigned long total = run + skipped;
+    sprintf(buf, "P:run=%5lu skip=%5lu (%3lu%%)", run, skipped, total ? skipped * 100 / total : 0);
+    Serial.print(buf);
+    need_separator = true;
+  }
+  
+  // Parked mode, sleep share over the last print interval
+  if (debug_flags.power) {
+    static unsigned long last_asleep_us = 0;
+    if (need_separator) Serial.print(F(" | "));
+    PowerStats stats;
+    get_power_stats(stats);
+    unsigned long asleep_ms = (stats.asleep_us - last_asleep_us) / 1000;
+    last_asleep_us = stats.asleep_us;
+    sprintf(buf, "Z:%s sleep=%3lu%% lat=%uus max=%uus", parked ? "PARK" : "RUN ",
+            asleep_ms * 100 / PRINT_INTERVAL, stats.last_latency_us, stats.max_latency_us);
+    Serial.print(buf);
+    need_separator = true;
+  }
+  
   // TX status and channels
   bool tx_on = is_tx_on();
   
@@ -1,27 +1,52 @@
 #include <Arduino.h>
-#include <avr/wdt.h>
 #include "receiver.h"
 #include "motors.h"
 #include "debug.h"
 #include "main.h"
 #include "onboard.h"
+#include "battery.h"
+#include "warmboot.h"
+#include "params.h"
+#include "power.h"
 #include "version.h"
 
 // Global state (non-static so debug.cpp can access)
 ControlMode control_mode = WAIT_TX;         // Start in waiting for TX to be powered on
 static bool last_takeover_state = false;    // Track takeover changes
 
-// Disable watchdog at boot to prevent reset loop
-void wdt_init(void) __attribute__((naked)) __attribute__((section(".init3")));
-void wdt_init(void) {
-  MCUSR = 0;
-  wdt_disable();
-}
+// Event-driven control: a pass only recomputes when an input changed, the motors are
+// ramping or holding on a timer, the mode just changed, or this interval has elapsed
+static const unsigned long CONTROL_MAX_INTERVAL_MS = 20;
+static unsigned long last_control_time = 0;
+static bool last_tx_powered_on = false;
+static bool mode_changed = true;
+
+// Cached mapped receiver values, refreshed only for channels that changed
+static uint8_t steering = 128;
+static uint8_t throttle = 0;
+static bool takeover_active = false;
+static bool reverse_switch = false;
+static int16_t max_throttle = 0;
+
+// Parked low-power mode: entered after tuning.park_idle_ms without input activity while
+// waiting for the TX or armed, at standstill (non-static so debug.cpp can access)
+bool parked = false;
+static unsigned long last_activity_time = 0;
+
+// Loop pass counters (non-static so debug.cpp can access)
+unsigned long control_passes_run = 0;
+unsigned long control_passes_skipped = 0;
 
 void setup() {
+  // Classify the reset and check for control state preserved by a watchdog reset
+  bool warm_boot = setup_warmboot();
+  
   // Initialize debug serial output
   setup_debug();
   
+  // Load tuning profiles from EEPROM before anything uses them
+  setup_params();
+  
   // Initialize the PWM receiver system
   setup_receiver();
   
@@ -31,9 +56,24 @@ void setup() {
   // Initialize onboard kid control hardware
   setup_onboard();
   
+  // Initialize battery voltage sampling for drive feed-forward
+  setup_battery();
+  
+  // Turn off unused peripherals and prepare idle sleep for the parked mode
+  setup_power();
+  
   // Enable watchdog timer - 500ms timeout
-  // If loop() doesn't call wdt_reset() within 500ms, MCU will reset
-  wdt_enable(WDTO_500MS);
+  // If loop() doesn't call pet_watchdog() within 500ms, MCU will reset
+  setup_watchdog();
+
+  // Warm boot: the car may still be rolling, ramp down from where we left off
+  // and get back to the control loop without the banner. The setup_* calls above all stay:
+  // the reset cleared every peripheral register and .bss (tuning), and none of them block.
+  if (warm_boot) {
+    restore_ramped_speed(get_reset_info().prev_speed);
+    Serial.println(F("Warm boot after watchdog reset, 'r' for details"));
+    return;
+  }
 
   // Print firmware version
   Serial.print(FPSTR(MOSTERRAK_LOGO));
@@ -42,24 +82,55 @@ void setup() {
 }
 
 void loop() {
-  wdt_reset();  // Pet the watchdog
+  pet_watchdog();  // Pet the watchdog
   
-  // Process debug commands
+  // Process debug commands and any pending EEPROM save
   process_debug_input();
+  params_service();
   
-  // Read all inputs
+  // Collect input events published by the receiver and onboard ISRs
   bool tx_powered_on = is_tx_on();
-  uint8_t steering = get_steering();
-  uint8_t throttle = get_throttle();
-  bool takeover_active = get_takeover();
-  bool reverse_switch = get_reverse();
+  uint8_t rx_changes = take_receiver_changes();
+  OnboardInputs onboard;
+  get_onboard_snapshot(onboard);
+  
+  // Skip the pass when nothing changed and no timer is due
+  unsigned long now = millis();
+  bool periodic = now - last_control_time >= CONTROL_MAX_INTERVAL_MS;
+  if (!periodic && !mode_changed && !rx_changes && tx_powered_on == last_tx_powered_on &&
+      !(onboard.pressed | onboard.released) && !motors_need_update()) {
+    control_passes_skipped++;
+    clear_wake();
+    print_debug_status();
+    if (parked) sleep_until_interrupt();
+    return;
+  }
+  control_passes_run++;
+  last_control_time = now;
+  last_tx_powered_on = tx_powered_on;
+  ControlMode prev_mode = control_mode;
+  
+  // Re-map only the receiver channels that changed (all of them on the periodic pass,
+  // which also picks up drift below the change threshold and tuning changes)
+  if (periodic) rx_changes = 0xFF;
+  uint8_t prev_steering = steering, prev_throttle = throttle;
+  bool prev_takeover = takeover_active, prev_reverse = reverse_switch;
+  if (rx_changes & _BV(RX_STEERING)) steering = get_steering();
+  if (rx_changes & _BV(RX_THROTTLE)) throttle = get_throttle();
+  if (rx_changes & _BV(RX_TAKEOVER)) takeover_active = get_takeover();
+  if (rx_changes & _BV(RX_REVERSE)) reverse_switch = get_reverse();
+  if (rx_changes & _BV(RX_MAX_THROTTLE)) max_throttle = get_max_throttle();
   uint8_t ramped_speed = get_ramped_speed();
-  int16_t max_throttle = get_max_throttle();
   
-  // Read onboard control states
-  bool rev_pedal = get_rev_pedal();
-  bool fwd_pedal = get_fwd_pedal();
-  bool speed_low = get_speed_low();
+  // Activity (keeps the car out of the parked mode): a control moved, not just receiver jitter
+  bool activity = steering != prev_steering || throttle != prev_throttle ||
+                  takeover_active != prev_takeover || reverse_switch != prev_reverse ||
+                  (onboard.pressed | onboard.released) || mode_changed;
+  
+  // Onboard control states (debounced)
+  bool rev_pedal = onboard.state & ONBOARD_REV_PEDAL;
+  bool fwd_pedal = onboard.state & ONBOARD_FWD_PEDAL;
+  bool speed_low = onboard.state & ONBOARD_SPEED_LOW;
   
   // Common state transitions (apply to all states)
   if (!tx_powered_on) {
@@ -74,35 +145,35 @@ void loop() {
   // Control state machine - each case handles its own state transitions
   switch (control_mode) {
     case WAIT_TX:
-      ramp_motors(0);
+      ramp_motors(0, RAMP_TX_LOSS_STOP);
       if (tx_powered_on && takeover_active) {
         control_mode = ARMING_REMOTE_CONTROL;
       }
       break;
 
     case SWITCHING_TO_REMOTE_CONTROL:
-      ramp_motors(0);
+      ramp_motors(0, RAMP_TAKEOVER_SWITCH);
       if (ramped_speed == 0) {
         control_mode = ARMING_REMOTE_CONTROL;
       }
       break;
 
     case SWITCHING_TO_KID_CONTROL:
-      ramp_motors(0);
+      ramp_motors(0, RAMP_TAKEOVER_SWITCH);
       if (ramped_speed == 0) {
         control_mode = ARMING_KID_CONTROL;
       }
       break;
 
     case ARMING_REMOTE_CONTROL:
-      ramp_motors(0);
+      ramp_motors(0, RAMP_TAKEOVER_SWITCH);
       if (throttle == 0 && ramped_speed == 0 && !reverse_switch) {
         control_mode = REMOTE_CONTROL;
       }
       break;
 
     case ARMING_KID_CONTROL:
-      ramp_motors(0);
+      ramp_motors(0, RAMP_TAKEOVER_SWITCH);
       if (!rev_pedal && !fwd_pedal && ramped_speed == 0) {
         control_mode = KID_CONTROL;
       }
@@ -110,21 +181,52 @@ void loop() {
 
     case REMOTE_CONTROL: {
       int16_t throttle_sign = reverse_switch ? -1 : 1;
-      ramp_motors(throttle * throttle_sign);
-      update_steering(steering);
+      update_steering(steering);    // First, so the cornering limit sees this pass's stick
+      ramp_motors(throttle * throttle_sign, RAMP_RC);
       break;
     }
 
-    case KID_CONTROL:
+    case KID_CONTROL: {
       update_steering(steering);
-      if (!fwd_pedal && !rev_pedal) ramp_motors(0);
-      else if (fwd_pedal && speed_low) ramp_motors(max_throttle / 2);
-      else if (fwd_pedal && !speed_low) ramp_motors(max_throttle);
-      else if (!fwd_pedal && speed_low) ramp_motors(-max_throttle / 2);
-      else if (!fwd_pedal && !speed_low) ramp_motors(-max_throttle);
+      int16_t target = 0;
+      if (fwd_pedal && speed_low) target = max_throttle / 2;
+      else if (fwd_pedal && !speed_low) target = max_throttle;
+      else if (rev_pedal && speed_low) target = -max_throttle / 2;
+      else if (rev_pedal && !speed_low) target = -max_throttle;
+      
+      // Launch profile when asking for more speed than we have, release profile otherwise
+      int16_t current = (int16_t)get_ramped_speed();
+      bool launch = abs(target) > abs(current);
+      ramp_motors(target, launch ? RAMP_KID_LAUNCH : RAMP_KID_RELEASE);
       break;
+    }
   }
   
+  // A mode change may enable a transition on the very next pass
+  mode_changed = control_mode != prev_mode;
+  
+  // Only RC and KID modes update the steering: release it when leaving them, or a burst
+  // in progress would stay latched (and keep motors_need_update() true)
+  bool steering_mode = control_mode == REMOTE_CONTROL || control_mode == KID_CONTROL;
+  bool was_steering_mode = prev_mode == REMOTE_CONTROL || prev_mode == KID_CONTROL;
+  if (was_steering_mode && !steering_mode) release_steering();
+  
+  // Parked mode: waiting for the TX or armed, stopped, with no activity for a while
+  bool parkable = (control_mode == WAIT_TX || control_mode == ARMING_REMOTE_CONTROL ||
+                   control_mode == ARMING_KID_CONTROL) && get_ramped_speed() == 0;
+  if (!parkable || activity || mode_changed) last_activity_time = now;
+  bool park = parkable && tuning.park_idle_ms && now - last_activity_time >= tuning.park_idle_ms;
+  if (park && !parked) park_motors();
+  if (!park && parked) disable_steering();    // Back to the hi-Z steering baseline
+  parked = park;
+  mark_control_pass();
+  
   // Debug output
   print_debug_status();
+  
+  // Preserve control state for a warm restart after a watchdog reset
+  save_warm_state(control_mode, get_ramped_speed());
+  
+  // Parked: sleep until the next interrupt instead of spinning
+  if (parked) sleep_until_interrupt();
 }
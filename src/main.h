@@ -17,5 +17,12 @@ enum ControlMode {
 // Global control mode state (accessible from debug.cpp)
 extern ControlMode control_mode;
 
+// Parked low-power mode active
+extern bool parked;
+
+// Event-driven loop statistics: passes that recomputed vs. skipped (nothing changed)
+extern unsigned long control_passes_run;
+extern unsigned long control_passes_skipped;
+
 #endif // MAIN_H
 
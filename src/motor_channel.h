@@ -0,0 +1,145 @@
+#ifndef MOTOR_CHANNEL_H
+#define MOTOR_CHANNEL_H
+
+#include <Arduino.h>
+#include <avr/io.h>
+
+// Register traits for MotorChannel: inline accessors, so every channel compiles down to
+// direct accesses to fixed I/O addresses (no pointers, no per-channel lookups)
+struct PortA {
+  static volatile uint8_t& reg() { return PORTA; }
+};
+
+struct PortC {
+  static volatile uint8_t& reg() { return PORTC; }
+};
+
+struct Timer2A {
+  static void set_duty(uint8_t duty) { OCR2A = duty; }
+  static void enable_boundary_irq() {
+    // TOV2 is set at every BOTTOM even while the interrupt is off: clear the stale flag so the
+    // first call really happens at the next BOTTOM (shared by both Timer2 channels)
+    if (TIMSK2 & _BV(TOIE2)) return;
+    TIFR2 = _BV(TOV2);
+    TIMSK2 |= _BV(TOIE2);
+  }
+};
+
+struct Timer2B {
+  static void set_duty(uint8_t duty) { OCR2B = duty; }
+  static void enable_boundary_irq() { Timer2A::enable_boundary_irq(); }
+};
+
+struct Timer3A {
+  static void set_duty(uint8_t duty) { OCR3A = duty; }
+  static void enable_boundary_irq() {
+    if (TIMSK3 & _BV(TOIE3)) return;
+    TIFR3 = _BV(TOV3);                   // Clear the stale flag, as for Timer2
+    TIMSK3 |= _BV(TOIE3);
+  }
+};
+
+// Extra zero-duty PWM cycles (~255us each) inserted when a channel reverses direction,
+// on top of the one cycle every direction change gets
+static const uint8_t MOTOR_REVERSAL_DEADTIME_CYCLES = 2;
+
+// One channel of the 100A driver: two direction pins on Port (DIR1/DIR2), PWM duty on a
+// phase correct timer compare register (Pwm), and a staged command applied at the timer's
+// BOTTOM. The speed ramp feeding it lives in ramp.h.
+//
+// Direction control: DIR1=0,DIR2=0 (brake), DIR1=1,DIR2=0 (fwd), DIR1=0,DIR2=1 (rev),
+// DIR1=DIR2=PWM=1 (hi-Z)
+template <class Port, uint8_t DIR1_BIT, uint8_t DIR2_BIT, class Pwm>
+class MotorChannel {
+public:
+  static const uint8_t DIR1 = _BV(DIR1_BIT);
+  static const uint8_t DIR2 = _BV(DIR2_BIT);
+  static const uint8_t DIR_MASK = DIR1 | DIR2;
+
+  // Drive the pins and duty directly, before the boundary interrupt is in use
+  void init(uint8_t dir, uint8_t duty) {
+    applied_dir = back_dir = front_dir = dir;
+    back_duty = front_duty = duty;
+    dead_cycles = 0;
+    reversal_waited = false;
+    Port::reg() = (Port::reg() & ~DIR_MASK) | dir;
+    Pwm::set_duty(duty);
+  }
+
+  // Stage a complete command, applied at the next PWM cycle boundary
+  void stage(uint8_t dir, uint8_t duty) {
+    if (back_dir == dir && back_duty == duty) return;
+    back_dir = dir;
+    back_duty = duty;
+    noInterrupts();
+    front_dir = dir;
+    front_duty = duty;
+    Pwm::enable_boundary_irq();
+    interrupts();
+  }
+
+  // Brake at 0, DIR1 for positive and DIR2 for negative speeds
+  void stage_speed(int16_t speed) {
+    if (speed == 0) stage(0, 0);
+    else if (speed < 0) stage(DIR2, -speed);
+    else stage(DIR1, speed);
+  }
+
+  // Apply the front command, called from the timer overflow ISR at BOTTOM. In phase correct
+  // mode the duty is latched at TOP, so a direction change first zeroes the duty, then switches
+  // the pins at a later BOTTOM where the output has been low at least since the previous TOP.
+  // Returns true while the channel is still in transition.
+  bool apply() {
+    uint8_t new_dir = front_dir;
+    uint8_t duty = front_duty;
+
+    if (applied_dir == new_dir) {
+      dead_cycles = 0;
+      Pwm::set_duty(duty);
+      return false;
+    }
+
+    if (dead_cycles == 0) {
+      Pwm::set_duty(0);                  // Output goes low from the next TOP
+      reversal_waited = is_reversal(new_dir);
+      dead_cycles = 1 + (reversal_waited ? MOTOR_REVERSAL_DEADTIME_CYCLES : 0);
+      return true;
+    }
+
+    if (--dead_cycles) return true;
+
+    // The command may have changed during the countdown (e.g. fwd -> brake -> rev staged
+    // before the brake was applied): a reversal still gets its full dead time
+    if (!reversal_waited && is_reversal(new_dir)) {
+      reversal_waited = true;
+      dead_cycles = MOTOR_REVERSAL_DEADTIME_CYCLES;
+      return true;
+    }
+
+    applied_dir = new_dir;
+    Port::reg() = (Port::reg() & ~DIR_MASK) | new_dir;
+    Pwm::set_duty(duty);                 // Latched at the next TOP, output still low until then
+    return false;
+  }
+
+private:
+  // Forward <-> reverse (or left <-> right) from the applied direction
+  bool is_reversal(uint8_t new_dir) const {
+    return (applied_dir ^ new_dir) == DIR_MASK && applied_dir != 0 && applied_dir != DIR_MASK;
+  }
+
+  // Control side copy of the last staged command
+  uint8_t back_dir;
+  uint8_t back_duty;
+
+  // Published command, read by the ISR
+  volatile uint8_t front_dir;
+  volatile uint8_t front_duty;
+
+  // Applied state, owned by the ISR
+  uint8_t applied_dir;
+  uint8_t dead_cycles;
+  bool reversal_waited;                  // Current transition already counts the reversal dead time
+};
+
+#endif // MOTOR_CHANNEL_H
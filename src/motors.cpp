@@ -1,5 +1,12 @@
 #include "motors.h"
+#include "battery.h"
+#include "thermal.h"
+#include "params.h"
+#include "motor_channel.h"
+#include "ramp.h"
+#include "steer_coupling.h"
 #include <avr/io.h>
+#include <avr/interrupt.h>
 
 // Drive motor control pin assignments
 // Direction control: A1=0,A2=0 (brake), A1=1,A2=0 (fwd), A1=0,A2=1 (rev)
@@ -13,25 +20,39 @@ static const uint8_t B1_PIN = 24;            // PA2 - Direction control bit 1
 static const uint8_t B2_PIN = 25;            // PA3 - Direction control bit 2
 static const uint8_t PB_PWM_PIN = 9;         // Timer2 OC2B - PWM steering control
 
-// Drive motor ramping constants (units per second)
-// RAMP_UP_RATE: 0 to 255 in 5.0 seconds -> 255 / 5.0 = 51.0 units/sec
-// RAMP_DN_RATE: 255 to 0 in 1.0 seconds -> 255 / 1.0 = 255.0 units/sec
-static const float RAMP_UP_RATE = 51.0;
-static const float RAMP_DN_RATE = 255.0;
+// Right rear motor, only used with REAR_DIFFERENTIAL (second driver board)
+// Direction control: C1=0,C2=0 (brake), C1=1,C2=0 (fwd), C1=0,C2=1 (rev)
+static const uint8_t C1_PIN = 30;            // PC7 - Direction control bit 1
+static const uint8_t C2_PIN = 31;            // PC6 - Direction control bit 2
+static const uint8_t PC_PWM_PIN = 5;         // Timer3 OC3A - PWM speed control
 
-// Drive motor ramping state
-static float current_speed = 0.0;          // Current speed (0.0 to 255.0)
+// Drive layout: false = one drive motor on channel A (stock car), true = independently
+// driven rear wheels, left on channel A and right on channel C, with an electronic differential
+static const bool REAR_DIFFERENTIAL = false;
+
+// Electronic differential: inner wheel speed reduction at full steering lock (Q8, 256 = stop)
+static const uint16_t DIFF_INNER_REDUCTION_Q8 = 102;   // ~40% slower at full lock
+
+// Driver channels (see motor_channel.h). In REAR_DIFFERENTIAL mode drive is the left rear wheel.
+static MotorChannel<PortA, PA0, PA1, Timer2A> drive;          // A1/A2 pins 22/23, PWM pin 10
+static MotorChannel<PortA, PA2, PA3, Timer2B> steering_motor; // B1/B2 pins 24/25, PWM pin 9
+static MotorChannel<PortC, PC7, PC6, Timer3A> drive_right;    // C1/C2 pins 30/31, PWM pin 5
+
+// Drive motor ramp, limits come from the active tuning profile (params.h), precomputed
+// per RampProfile as Q16 acceleration and jerk limits
+static SCurveRamp drive_ramp;
 static unsigned long last_update_time = 0; // Last update timestamp in milliseconds
 
-// Steering motor constants
-static const uint8_t STEER_CENTER_VALUE = 128;     // Center position value
-static const uint8_t STEER_DEADZONE = 16;          // Deadzone radius around center
-static const uint8_t STEER_FULL_PWM = 254;         // Full power PWM (driver doesn't handle 255)
-static const uint8_t STEER_HOLD_PWM = 13;          // Hold power PWM (~5%)
-static const unsigned long STEER_HOLD_TIME = 2000; // Time before switching to hold (ms)
+// Last steering stick position, used for the cornering speed limit and to split the drive
+// speed in REAR_DIFFERENTIAL mode
+static uint8_t steering_stick = 128;
+
+// Steering motor constants (deadzone, hold PWM and hold time are tunable, see params.h,
+// full stick burst PWM follows STEER_BURST_PWM_CURVE)
 
 // Start of steering
 static unsigned long steering_start_time = 0;
+static bool steering_holding = false;      // Hold PWM applied for the current stick position
 
 // Steering state machine
 enum SteeringStickPosition {
@@ -42,6 +63,18 @@ enum SteeringStickPosition {
 
 static SteeringStickPosition prev_steer_state = STEER_CENTER;
 
+// Timer2 overflow (BOTTOM) ISR - only enabled while a staged command is being applied
+ISR(TIMER2_OVF_vect) {
+  bool busy = drive.apply();
+  busy |= steering_motor.apply();
+  if (!busy) TIMSK2 &= ~_BV(TOIE2);      // Nothing left to do until the next stage()
+}
+
+// Timer3 overflow (BOTTOM) ISR - right rear motor in REAR_DIFFERENTIAL mode
+ISR(TIMER3_OVF_vect) {
+  if (!drive_right.apply()) TIMSK3 &= ~_BV(TOIE3);
+}
+
 void setup_motors() {
   // Configure drive motor control pins
   pinMode(A1_PIN, OUTPUT);
@@ -59,12 +92,12 @@ void setup_motors() {
   TCCR2A = _BV(COM2A1) | _BV(COM2B1) | _BV(WGM20); // Phase Correct PWM mode, both OC2A and OC2B
   TCCR2B = _BV(CS21);  // Prescaler 8: CS22=0, CS21=1, CS20=0
   
-  // Initialize PWM duty cycles to 0 (stopped)
-  OCR2A = 0;  // PA_PWM_PIN (pin 10) - drive motor
-  OCR2B = 0;  // PB_PWM_PIN (pin 9) - steering motor
+  // Initialize PWM duty cycles and staged commands (drive brake, steering hi-Z)
+  drive.init(0, 0);                                       // PA_PWM_PIN (pin 10) - drive motor
+  steering_motor.init(steering_motor.DIR_MASK, 255);      // PB_PWM_PIN (pin 9) - steering motor
+  TIFR2 = _BV(TOV2);
   
   // Initialize ramping state
-  current_speed = 0.0;
   last_update_time = millis();
   
   // Configure steering motor control pins
@@ -72,113 +105,133 @@ void setup_motors() {
   pinMode(B2_PIN, OUTPUT);
   pinMode(PB_PWM_PIN, OUTPUT);
   
-  // Initialize steering to safe state (high-Z mode: B1=1, B2=1, PWM=255)
-  disable_steering();
+  if (REAR_DIFFERENTIAL) {
+    // Right rear motor on Timer3 OC3A, same ~3.9kHz 8-bit Phase Correct PWM as Timer2
+    pinMode(C1_PIN, OUTPUT);
+    pinMode(C2_PIN, OUTPUT);
+    pinMode(PC_PWM_PIN, OUTPUT);
+    TCCR3A = _BV(COM3A1) | _BV(WGM30);   // Phase Correct PWM 8-bit (TOP=0xFF), OC3A
+    TCCR3B = _BV(CS31);                  // Prescaler 8
+    drive_right.init(0, 0);
+    TIFR3 = _BV(TOV3);
+  } else {
+    // The Arduino core starts Timer3 for analogWrite(), stop it so setup_power() can power it down
+    TCCR3B = 0;
+    TCCR3A = 0;
+  }
 }
 
-void ramp_motors(int16_t target_speed) {
-  // Get elapsed time since last update
+void ramp_motors(int16_t target_speed, RampProfile profile) {
+  // Get elapsed time since last update (capped so the Q16 step can't overflow)
   unsigned long now = millis();
   unsigned long elapsed_ms = now - last_update_time;
   last_update_time = now;
+  if (elapsed_ms > 1000) elapsed_ms = 1000;
   
-  // Clamp to 254 max - driver doesn't handle 255 correctly
-  if (target_speed < -254) target_speed = -254;
-  if (target_speed > 254) target_speed = 254;
+  // Clamp to 254 max - driver doesn't handle 255 correctly - or less if the driver is hot
+  // or the pack is low
+  int16_t limit = get_thermal_limit();
+  int16_t battery_limit = get_battery_limit();
+  if (battery_limit < limit) limit = battery_limit;
+  if (target_speed < -limit) target_speed = -limit;
+  if (target_speed > limit) target_speed = limit;
 
-  // Convert target to float and calculate elapsed time in seconds
-  float target_speed_f = (float)target_speed;
-  float elapsed_sec = elapsed_ms / 1000.0;
-  
-  // Apply ramping
-  if (current_speed < target_speed_f) {
-    if (current_speed > 0) {
-      // We are speeding up
-      current_speed += RAMP_UP_RATE * elapsed_sec;
-    } else {
-      // We are slowing down
-      current_speed += RAMP_DN_RATE * elapsed_sec;
-    }
-    if (current_speed > target_speed_f) {
-      current_speed = target_speed_f;  // Clamp to target
-    }
-  }
-  else if (current_speed > target_speed_f) {
-    if (current_speed > 0) {
-      // We are slowing down
-      current_speed -= RAMP_DN_RATE * elapsed_sec;
-    } else {
-      // We are speeding up (in reverse)
-      current_speed -= RAMP_UP_RATE * elapsed_sec;
-    }
-    if (current_speed < target_speed_f) {
-      current_speed = target_speed_f;  // Clamp to target
-    }
-  }
-  // else: already at target, no change needed
+  // Cornering speed limit while the stick asks for hard steering (steer_coupling.h)
+  target_speed = limit_corner_speed(target_speed, steering_stick);
+
+  // Apply jerk-limited ramping with the limits of the current driving context
+  int16_t speed = drive_ramp.update(target_speed, elapsed_ms, tuning.ramp[profile]);
   
-  // Apply to motors using the rounded ramped speed
-  update_motors(get_ramped_speed());
+  // Apply to motors using the rounded ramped speed, corrected for pack voltage
+  int16_t duty = compensate_battery(speed);
+  update_motors(duty);
+
+  // Driver heating follows the effective (voltage-compensated) drive level
+  update_thermal(duty < 0 ? -duty : duty, elapsed_ms);
 }
 
 uint16_t get_ramped_speed() {
-  // Convert float speed to int16_t with rounding
-  if (current_speed < 0) return (int16_t)(current_speed - 0.5);
-  else return (int16_t)(current_speed + 0.5);
+  return drive_ramp.speed();
+}
+
+void restore_ramped_speed(int16_t speed) {
+  // Resume ramping from a speed preserved across a reset instead of stepping to 0
+  if (speed < -254) speed = -254;
+  if (speed > 254) speed = 254;
+  drive_ramp.set_speed(speed);
+  last_update_time = millis();
+}
+
+bool motors_need_update() {
+  // Still ramping towards the last target
+  if (!drive_ramp.settled()) return true;
+  
+  // Steering burst is over but the switch to hold PWM hasn't been applied yet
+  return prev_steer_state != STEER_CENTER && !steering_holding &&
+         millis() - steering_start_time >= tuning.steer_hold_ms;
 }
 
 void disable_motors() {
-  digitalWrite(A1_PIN, HIGH);
-  digitalWrite(A2_PIN, HIGH);
-  OCR2A = 255;
+  drive.stage(drive.DIR_MASK, 255);
+  if (REAR_DIFFERENTIAL) drive_right.stage(drive_right.DIR_MASK, 255);
 }
 
 void update_motors(int16_t speed) {
   // Simply apply the requested speed and direction - no business logic
-  
-  if (speed == 0) {
-    // Brake: A1=0, A2=0 (regardless of reverse flag)
-    digitalWrite(A1_PIN, LOW);
-    digitalWrite(A2_PIN, LOW);
-    OCR2A = 0;
-  }
-  else if (speed < 0) {
-    // Reverse: A1=0, A2=1
-    digitalWrite(A1_PIN, LOW);
-    digitalWrite(A2_PIN, HIGH);
-    OCR2A = -speed;
+  // Brake: A1=0, A2=0 (regardless of reverse flag), Reverse: A1=0, A2=1, Forward: A1=1, A2=0
+  if (!REAR_DIFFERENTIAL) {
+    drive.stage_speed(speed);
+    return;
   }
-  else {
-    // Forward: A1=1, A2=0
-    digitalWrite(A1_PIN, HIGH);
-    digitalWrite(A2_PIN, LOW);
-    OCR2A = speed;
+  
+  // Electronic differential: slow the inner wheel in proportion to the steering input
+  uint8_t offset = steering_stick >= 128 ? steering_stick - 128 : 128 - steering_stick;
+  if (offset > 127) offset = 127;
+  uint16_t reduction_q8 = (uint16_t)(((uint32_t)offset * DIFF_INNER_REDUCTION_Q8) >> 7);
+  int16_t inner = (int16_t)(((int32_t)speed * (256 - reduction_q8)) >> 8);
+  
+  if (steering_stick >= 128) {
+    drive.stage_speed(speed);            // Turning right: left wheel is outer
+    drive_right.stage_speed(inner);
+  } else {
+    drive.stage_speed(inner);
+    drive_right.stage_speed(speed);
   }
 }
 
 void steer_right(uint8_t pwm_duty) {
-  digitalWrite(B1_PIN, HIGH);
-  digitalWrite(B2_PIN, LOW);
-  OCR2B = pwm_duty;
+  steering_motor.stage(steering_motor.DIR1, pwm_duty);   // B1=1, B2=0
 }
 
 void steer_left(uint8_t pwm_duty) {
-  digitalWrite(B1_PIN, LOW);
-  digitalWrite(B2_PIN, HIGH);
-  OCR2B = pwm_duty;
+  steering_motor.stage(steering_motor.DIR2, pwm_duty);   // B1=0, B2=1
 }
 
 void disable_steering() {
-  digitalWrite(B1_PIN, HIGH);
-  digitalWrite(B2_PIN, HIGH);
-  OCR2B = 255;
+  steering_motor.stage(steering_motor.DIR_MASK, 255);    // B1=1, B2=1, PWM=255 (hi-Z)
+}
+
+void release_steering() {
+  // Leaving a steering mode: back to hi-Z, and no burst/hold timer left running
+  prev_steer_state = STEER_CENTER;
+  steering_holding = false;
+  disable_steering();
+}
+
+void park_motors() {
+  // Lowest draw: all driver inputs low (optocoupler LEDs off), i.e. both channels braked
+  drive.stage(0, 0);
+  steering_motor.stage(0, 0);
+  if (REAR_DIFFERENTIAL) drive_right.stage(0, 0);
 }
 
 
 void update_steering(uint8_t steering) {
-  // Calculate deadzone boundaries
-  uint8_t center_low = STEER_CENTER_VALUE - STEER_DEADZONE;
-  uint8_t center_high = STEER_CENTER_VALUE + STEER_DEADZONE;
+  steering_stick = steering;
+  
+  // Deadzone boundaries (precomputed from the active profile)
+  uint8_t center_low = tuning.steer_center_low;
+  uint8_t center_high = tuning.steer_center_high;
   SteeringStickPosition new_steer_state;
 
   if (steering < center_low) {
@@ -192,24 +245,31 @@ void update_steering(uint8_t steering) {
   if (new_steer_state != prev_steer_state) {
     prev_steer_state = new_steer_state;
     steering_start_time = millis();
+    steering_holding = false;
   }
 
+  // Steering authority: full stick burst power goes down as the car speeds up
+  uint8_t burst_pwm = steer_burst_pwm(drive_ramp.speed());
+  if (burst_pwm < tuning.steer_hold_pwm) burst_pwm = tuning.steer_hold_pwm;
+
   switch (new_steer_state) {
     case STEER_CENTER:
       disable_steering();
       break;
     case STEER_LEFT:
-      if (millis() - steering_start_time < STEER_HOLD_TIME) {
-        steer_left(map(steering, center_low, 0, STEER_HOLD_PWM, STEER_FULL_PWM));
+      if (millis() - steering_start_time < tuning.steer_hold_ms) {
+        steer_left(map(steering, center_low, 0, tuning.steer_hold_pwm, burst_pwm));
       } else {
-        steer_left(STEER_HOLD_PWM);
+        steer_left(tuning.steer_hold_pwm);
+        steering_holding = true;
       }
       break;
     case STEER_RIGHT:
-      if (millis() - steering_start_time < STEER_HOLD_TIME) {
-        steer_right(map(steering, center_high, 255, STEER_HOLD_PWM, STEER_FULL_PWM));
+      if (millis() - steering_start_time < tuning.steer_hold_ms) {
+        steer_right(map(steering, center_high, 255, tuning.steer_hold_pwm, burst_pwm));
       } else {
-        steer_right(STEER_HOLD_PWM);
+        steer_right(tuning.steer_hold_pwm);
+        steering_holding = true;
       }
       break;
   }
@@ -2,13 +2,18 @@
 #define MOTORS_H
 
 #include <Arduino.h>
+#include "params.h"
 
 void setup_motors();
-void ramp_motors(int16_t speed);
+void ramp_motors(int16_t speed, RampProfile profile);
 void update_steering(uint8_t steering);
 uint16_t get_ramped_speed();
+void restore_ramped_speed(int16_t speed);
+bool motors_need_update();
 void update_motors(int16_t speed);
 void disable_motors();
 void disable_steering();
+void release_steering();
+void park_motors();
 
 #endif // MOTORS_H
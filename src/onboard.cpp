@@ -1,26 +1,93 @@
 #include "onboard.h"
+#include "params.h"
+#include <avr/io.h>
+#include <avr/interrupt.h>
 
 // Kid control hardware pins (with internal pullups)
-static const uint8_t PIN_REV_PEDAL = 26;    // LOW = REV + pedal pressed
-static const uint8_t PIN_FWD_PEDAL = 27;    // LOW = FWD + pedal pressed
-static const uint8_t PIN_SPEED_LOW = 28;    // LOW = HI speed, HIGH = LO speed
+static const uint8_t PIN_REV_PEDAL = 26;    // PA4 - LOW = REV + pedal pressed
+static const uint8_t PIN_FWD_PEDAL = 27;    // PA5 - LOW = FWD + pedal pressed
+static const uint8_t PIN_SPEED_LOW = 28;    // PA6 - LOW = HI speed, HIGH = LO speed
+
+// All three inputs live on PORTA (PA4..PA6), which has no pin change interrupts,
+// so they are sampled together from the Timer0 compare B interrupt (~1kHz)
+static const uint8_t ONBOARD_PORT_SHIFT = PA4;
+static const uint8_t ONBOARD_PORT_MASK = _BV(PA4) | _BV(PA5) | _BV(PA6);
+
+// Samples (~1ms each) an input must stay at its new level before the change is accepted
+// come from the active tuning profile (tuning.debounce_ms)
+
+// Debounced state and latched edges (written by ISR, read by API)
+volatile uint8_t onboard_state = 0;
+volatile uint8_t onboard_pressed = 0;
+volatile uint8_t onboard_released = 0;
+volatile unsigned long onboard_changed_ms[ONBOARD_INPUT_COUNT];
+
+// Consecutive samples each input has disagreed with the debounced state
+static uint8_t onboard_stable_count[ONBOARD_INPUT_COUNT];
+
+// Timer0 compare B ISR - runs once per Timer0 cycle alongside Arduino's millis() overflow
+ISR(TIMER0_COMPB_vect) {
+  uint8_t raw = (uint8_t)(~PINA & ONBOARD_PORT_MASK) >> ONBOARD_PORT_SHIFT;  // Active LOW
+  uint8_t diff = raw ^ onboard_state;
+  if (!diff && !(onboard_stable_count[0] | onboard_stable_count[1] | onboard_stable_count[2])) {
+    return;                                // Nothing moving, fast path
+  }
+
+  for (uint8_t i = 0; i < ONBOARD_INPUT_COUNT; i++) {
+    uint8_t bit = _BV(i);
+    if (!(diff & bit)) {
+      onboard_stable_count[i] = 0;         // Bounced back, restart the count
+    } else if (++onboard_stable_count[i] >= tuning.debounce_ms) {
+      onboard_stable_count[i] = 0;
+      onboard_state ^= bit;
+      if (raw & bit) onboard_pressed |= bit;
+      else onboard_released |= bit;
+      onboard_changed_ms[i] = millis();
+    }
+  }
+}
 
 void setup_onboard() {
   // Initialize kid control input pins with pullups
   pinMode(PIN_REV_PEDAL, INPUT_PULLUP);
   pinMode(PIN_FWD_PEDAL, INPUT_PULLUP);
   pinMode(PIN_SPEED_LOW, INPUT_PULLUP);
+
+  // Start from the current pin levels so boot doesn't produce edge events
+  onboard_state = (uint8_t)(~PINA & ONBOARD_PORT_MASK) >> ONBOARD_PORT_SHIFT;
+  unsigned long now = millis();
+  for (uint8_t i = 0; i < ONBOARD_INPUT_COUNT; i++) {
+    onboard_changed_ms[i] = now;
+    onboard_stable_count[i] = 0;
+  }
+
+  // Timer0 is owned by millis(): only add a compare B interrupt mid-cycle
+  OCR0B = 128;
+  TIFR0 = _BV(OCF0B);
+  TIMSK0 |= _BV(OCIE0B);
+}
+
+void get_onboard_snapshot(OnboardInputs& inputs) {
+  noInterrupts();
+  inputs.state = onboard_state;
+  inputs.pressed = onboard_pressed;
+  inputs.released = onboard_released;
+  for (uint8_t i = 0; i < ONBOARD_INPUT_COUNT; i++) {
+    inputs.changed_ms[i] = onboard_changed_ms[i];
+  }
+  onboard_pressed = 0;
+  onboard_released = 0;
+  interrupts();
 }
 
 bool get_rev_pedal() {
-  return !digitalRead(PIN_REV_PEDAL);  // Active LOW
+  return onboard_state & ONBOARD_REV_PEDAL;
 }
 
 bool get_fwd_pedal() {
-  return !digitalRead(PIN_FWD_PEDAL);  // Active LOW
+  return onboard_state & ONBOARD_FWD_PEDAL;
 }
 
 bool get_speed_low() {
-  return !digitalRead(PIN_SPEED_LOW);  // Active LOW
+  return onboard_state & ONBOARD_SPEED_LOW;
 }
-
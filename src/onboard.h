@@ -3,13 +3,31 @@
 
 #include <Arduino.h>
 
+// Onboard input bits, as used in OnboardInputs masks
+enum OnboardInput {
+  ONBOARD_REV_PEDAL = _BV(0),
+  ONBOARD_FWD_PEDAL = _BV(1),
+  ONBOARD_SPEED_LOW = _BV(2),
+};
+static const uint8_t ONBOARD_INPUT_COUNT = 3;
+
+// Debounced snapshot of the onboard controls
+struct OnboardInputs {
+  uint8_t state;                                   // Active (pressed) inputs
+  uint8_t pressed;                                 // Inputs that became active since last snapshot
+  uint8_t released;                                // Inputs that became inactive since last snapshot
+  unsigned long changed_ms[ONBOARD_INPUT_COUNT];   // millis() of each input's last debounced change
+};
+
 // Initialize onboard kid control hardware
 void setup_onboard();
 
-// Read onboard control states
+// Copy the debounced state and consume the pending edge events
+void get_onboard_snapshot(OnboardInputs& inputs);
+
+// Read onboard control states (debounced)
 bool get_rev_pedal();    // Returns true if reverse pedal is pressed
 bool get_fwd_pedal();    // Returns true if forward pedal is pressed
 bool get_speed_low();    // Returns true if low speed mode is active
 
 #endif // ONBOARD_H
-
@@ -0,0 +1,327 @@
+#include "params.h"
+#include <avr/eeprom.h>
+#include <avr/pgmspace.h>
+#include <util/crc16.h>
+#include <stddef.h>
+
+// A named set of tuning parameters
+struct ParamProfile {
+  char name[PARAM_PROFILE_NAME_LEN];
+  TuningParams params;
+};
+
+// EEPROM image, stored at address 0 and protected by a CRC16
+struct ParamStore {
+  uint16_t magic;
+  uint8_t version;
+  uint8_t active;                                  // Active profile index
+  ParamProfile profiles[PARAM_PROFILE_COUNT];
+  uint16_t crc;
+};
+
+static const uint16_t PARAM_STORE_MAGIC = 0x4D54;  // "MT"
+static const uint8_t PARAM_STORE_VERSION = 3;      // Bump when TuningParams layout changes
+static const uint8_t PARAM_DEFAULT_PROFILE = 1;    // "kid" matches the original hardcoded tuning
+
+// Factory profiles
+static const ParamProfile DEFAULT_PROFILES[PARAM_PROFILE_COUNT] PROGMEM = {
+  //                 ramp up/dn jerk  dz hold hold_ms  tmo  min   max  deb park
+  { "toddler", {      30, 200,  500,  16,  13,  2000, 100, 1100, 1900,  20,  60 } },
+  { "kid",     {      51, 255,  400,  16,  13,  2000, 100, 1100, 1900,  20,  60 } },
+  { "parent",  {      80, 255,  300,  16,  13,  2000, 100, 1100, 1900,  20,  60 } },
+};
+
+// Ramp profile shapes, scaling the active profile's ramp_up, ramp_dn and jerk_ms (Q8, 256 = 1x)
+struct RampShape {
+  uint16_t up_q8;
+  uint16_t dn_q8;
+  uint16_t jerk_q8;
+};
+
+static const RampShape RAMP_SHAPES[RAMP_PROFILE_COUNT] PROGMEM = {
+  //  up   dn  jerk
+  { 256, 256,  256 },    // RAMP_KID_LAUNCH: gentlest start
+  { 256, 256,  128 },    // RAMP_KID_RELEASE: start slowing down sooner after the pedal is released
+  { 256, 256,  128 },    // RAMP_RC: more responsive to the stick
+  { 256, 256,  256 },    // RAMP_TAKEOVER_SWITCH: smooth handover stop
+  { 256, 384,   64 },    // RAMP_TX_LOSS_STOP: brake 1.5x harder, almost straight away
+};
+
+// Parameter descriptors for the serial get/set commands
+struct ParamInfo {
+  char name[14];
+  uint8_t offset;                                  // Offset in TuningParams
+  uint8_t size;                                    // 1 or 2 bytes
+  uint16_t min_value;
+  uint16_t max_value;
+};
+
+#define PARAM_FIELD(field) offsetof(TuningParams, field), sizeof(((TuningParams*)0)->field)
+
+static const ParamInfo PARAM_INFO[] PROGMEM = {
+  { "ramp_up",       PARAM_FIELD(ramp_up_rate),   1, 1000 },
+  { "ramp_dn",       PARAM_FIELD(ramp_dn_rate),   1, 2000 },
+  { "jerk_ms",       PARAM_FIELD(jerk_ms),        0, 2000 },
+  { "steer_dz",      PARAM_FIELD(steer_deadzone), 0,  100 },
+  { "steer_hold",    PARAM_FIELD(steer_hold_pwm), 0,  254 },
+  { "steer_hold_ms", PARAM_FIELD(steer_hold_ms),  0, 10000 },
+  { "rx_timeout_ms", PARAM_FIELD(rx_timeout_ms), 30, 1000 },
+  { "rx_min_us",     PARAM_FIELD(rx_min_us),    800, 1500 },
+  { "rx_max_us",     PARAM_FIELD(rx_max_us),   1500, 2200 },
+  { "debounce_ms",   PARAM_FIELD(debounce_ms),    1,  200 },
+  { "park_idle_s",   PARAM_FIELD(park_idle_s),    0, 3600 },
+};
+static const uint8_t PARAM_INFO_COUNT = sizeof(PARAM_INFO) / sizeof(PARAM_INFO[0]);
+
+// Minimum pulse span so the 0-255 mapping stays meaningful
+static const uint16_t RX_MIN_SPAN_US = 200;
+
+// RAM copy of the EEPROM image and the derived tuning actually used
+static ParamStore store;
+TuningDerived tuning;
+
+// Pending non-blocking save: next byte to write, or -1 when idle
+static int16_t save_pos = -1;
+
+// Pending :list output: next line (profiles, then parameters), or -1 when idle
+static int8_t list_pos = -1;
+static const uint8_t LIST_LINE_MAX = 24;           // Longest listing line, incl. CR LF
+
+// Tuning command line buffer
+static char line_buf[40];
+static uint8_t line_len = 0;
+static bool line_active = false;
+
+static uint16_t store_crc() {
+  const uint8_t* p = (const uint8_t*)&store;
+  uint16_t crc = 0xFFFF;
+  for (uint8_t i = 0; i < offsetof(ParamStore, crc); i++) {
+    crc = _crc16_update(crc, p[i]);
+  }
+  return crc;
+}
+
+static void load_defaults() {
+  store.magic = PARAM_STORE_MAGIC;
+  store.version = PARAM_STORE_VERSION;
+  store.active = PARAM_DEFAULT_PROFILE;
+  memcpy_P(store.profiles, DEFAULT_PROFILES, sizeof(store.profiles));
+}
+
+// Acceleration limit in Q16 per ms, and the jerk that reaches it in jerk_ms
+static void ramp_limits(uint16_t rate, uint16_t rate_q8, uint16_t jerk_ms,
+                        int32_t& accel_q16, int32_t& jerk_q16) {
+  accel_q16 = (((int32_t)rate * rate_q8) << 8) / 1000;
+  if (accel_q16 < 1) accel_q16 = 1;
+  jerk_q16 = jerk_ms ? accel_q16 / jerk_ms : accel_q16;
+  if (jerk_q16 < 1) jerk_q16 = 1;
+}
+
+// Precompute the fixed-point form of the active profile
+static void apply_profile() {
+  const TuningParams& p = store.profiles[store.active].params;
+  TuningDerived d;
+
+  for (uint8_t i = 0; i < RAMP_PROFILE_COUNT; i++) {
+    RampShape shape;
+    memcpy_P(&shape, &RAMP_SHAPES[i], sizeof(shape));
+    uint16_t jerk_ms = ((uint32_t)p.jerk_ms * shape.jerk_q8) >> 8;
+    ramp_limits(p.ramp_up_rate, shape.up_q8, jerk_ms, d.ramp[i].up_q16, d.ramp[i].jerk_up_q16);
+    ramp_limits(p.ramp_dn_rate, shape.dn_q8, jerk_ms, d.ramp[i].dn_q16, d.ramp[i].jerk_dn_q16);
+  }
+  d.steer_center_low = 128 - p.steer_deadzone;
+  d.steer_center_high = 128 + p.steer_deadzone;
+  d.steer_hold_pwm = p.steer_hold_pwm;
+  d.steer_hold_ms = p.steer_hold_ms;
+  d.rx_timeout_ms = p.rx_timeout_ms;
+  d.rx_min_us = p.rx_min_us;
+  uint16_t span = p.rx_max_us - p.rx_min_us;
+  d.rx_scale_q16 = ((255UL << 16) + span - 1) / span;  // Round up so rx_max_us maps to 255
+  d.debounce_ms = p.debounce_ms;
+  d.park_idle_ms = (uint32_t)p.park_idle_s * 1000;
+
+  // ISRs read the timeout and debounce time
+  noInterrupts();
+  tuning = d;
+  interrupts();
+}
+
+void setup_params() {
+  eeprom_read_block(&store, (const void*)0, sizeof(store));
+
+  if (store.magic != PARAM_STORE_MAGIC || store.version != PARAM_STORE_VERSION ||
+      store.active >= PARAM_PROFILE_COUNT || store.crc != store_crc()) {
+    load_defaults();
+  }
+  apply_profile();
+}
+
+// Start (or restart) writing the RAM image to EEPROM
+static void start_save() {
+  store.crc = store_crc();
+  save_pos = 0;
+}
+
+static void print_list_line();
+
+void params_service() {
+  // One listing line per call, and only when it fits in the serial TX buffer
+  if (list_pos >= 0 && Serial.availableForWrite() >= LIST_LINE_MAX) print_list_line();
+
+  if (save_pos < 0 || !eeprom_is_ready()) return;
+
+  // One byte per call: eeprom_update_byte only starts the write (~3.4ms in hardware)
+  eeprom_update_byte((uint8_t*)(size_t)save_pos, ((const uint8_t*)&store)[save_pos]);
+  if (++save_pos >= (int16_t)sizeof(store)) {
+    save_pos = -1;
+    Serial.println(F("Params saved"));
+  }
+}
+
+static uint16_t read_param(const ParamInfo& info) {
+  const uint8_t* p = (const uint8_t*)&store.profiles[store.active].params + info.offset;
+  return info.size == 1 ? *p : *(const uint16_t*)p;
+}
+
+static void write_param(const ParamInfo& info, uint16_t value) {
+  uint8_t* p = (uint8_t*)&store.profiles[store.active].params + info.offset;
+  if (info.size == 1) *p = (uint8_t)value;
+  else *(uint16_t*)p = value;
+}
+
+static bool find_param(const char* name, ParamInfo& info) {
+  for (uint8_t i = 0; i < PARAM_INFO_COUNT; i++) {
+    memcpy_P(&info, &PARAM_INFO[i], sizeof(info));
+    if (strcmp(name, info.name) == 0) return true;
+  }
+  return false;
+}
+
+static void print_param(const ParamInfo& info) {
+  Serial.print(info.name);
+  Serial.print(F(" = "));
+  Serial.println(read_param(info));
+}
+
+// Print the next line of a pending :list
+static void print_list_line() {
+  if (list_pos < PARAM_PROFILE_COUNT) {
+    uint8_t i = list_pos;
+    Serial.print(i == store.active ? F("* ") : F("  "));
+    Serial.print(i);
+    Serial.print(' ');
+    Serial.println(store.profiles[i].name);
+  } else {
+    ParamInfo info;
+    memcpy_P(&info, &PARAM_INFO[list_pos - PARAM_PROFILE_COUNT], sizeof(info));
+    print_param(info);
+  }
+  if (++list_pos >= PARAM_PROFILE_COUNT + PARAM_INFO_COUNT) list_pos = -1;
+}
+
+// Split the next space-separated token in place
+static char* next_token(char*& p) {
+  while (*p == ' ') p++;
+  if (!*p) return NULL;
+  char* token = p;
+  while (*p && *p != ' ') p++;
+  if (*p) *p++ = '\0';
+  return token;
+}
+
+static bool parse_number(const char* s, uint16_t& value) {
+  if (!s || !*s) return false;
+  uint32_t v = 0;
+  for (; *s; s++) {
+    if (*s < '0' || *s > '9') return false;
+    v = v * 10 + (*s - '0');
+    if (v > 0xFFFF) return false;
+  }
+  value = (uint16_t)v;
+  return true;
+}
+
+static void run_command(char* line) {
+  char* cmd = next_token(line);
+  char* arg1 = next_token(line);
+  char* arg2 = next_token(line);
+  if (!cmd) return;
+
+  ParamInfo info;
+  uint16_t value;
+
+  if (strcmp(cmd, "list") == 0) {
+    list_pos = 0;                                  // Printed by params_service(), line by line
+  } else if (strcmp(cmd, "get") == 0) {
+    if (arg1 && find_param(arg1, info)) print_param(info);
+    else Serial.println(F("Unknown param"));
+  } else if (strcmp(cmd, "set") == 0) {
+    if (!arg1 || !find_param(arg1, info)) {
+      Serial.println(F("Unknown param"));
+    } else if (!parse_number(arg2, value) || value < info.min_value || value > info.max_value) {
+      Serial.print(F("Range "));
+      Serial.print(info.min_value);
+      Serial.print('-');
+      Serial.println(info.max_value);
+    } else {
+      uint16_t old_value = read_param(info);
+      write_param(info, value);
+      const TuningParams& p = store.profiles[store.active].params;
+      if (p.rx_max_us < p.rx_min_us + RX_MIN_SPAN_US) {
+        write_param(info, old_value);
+        Serial.println(F("rx_max_us - rx_min_us too small"));
+        return;
+      }
+      apply_profile();
+      if (save_pos >= 0) start_save();             // Image changed under a running save
+      print_param(info);
+    }
+  } else if (strcmp(cmd, "profile") == 0) {
+    uint8_t index = PARAM_PROFILE_COUNT;
+    if (parse_number(arg1, value)) {
+      index = value;
+    } else if (arg1) {
+      for (uint8_t i = 0; i < PARAM_PROFILE_COUNT; i++) {
+        if (strncmp(arg1, store.profiles[i].name, PARAM_PROFILE_NAME_LEN) == 0) index = i;
+      }
+    }
+    if (index >= PARAM_PROFILE_COUNT) {
+      Serial.println(F("Unknown profile"));
+      return;
+    }
+    store.active = index;
+    apply_profile();
+    if (save_pos >= 0) start_save();
+    Serial.print(F("Profile "));
+    Serial.println(store.profiles[index].name);
+  } else if (strcmp(cmd, "save") == 0) {
+    start_save();
+  } else if (strcmp(cmd, "defaults") == 0) {
+    load_defaults();
+    apply_profile();
+    if (save_pos >= 0) start_save();
+    Serial.println(F("Defaults loaded (not saved)"));
+  } else {
+    Serial.println(F("Commands: :list :get <p> :set <p> <v> :profile <n> :save :defaults"));
+  }
+}
+
+bool params_input(char c) {
+  if (!line_active) {
+    if (c != ':') return false;
+    line_active = true;
+    line_len = 0;
+    return true;
+  }
+
+  if (c == '\r' || c == '\n') {
+    line_buf[line_len] = '\0';
+    line_active = false;
+    run_command(line_buf);
+  } else if (c == '\b' || c == 0x7F) {
+    if (line_len) line_len--;
+  } else if (line_len < sizeof(line_buf) - 1) {
+    line_buf[line_len++] = c;
+  }
+  return true;
+}
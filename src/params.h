@@ -0,0 +1,64 @@
+#ifndef PARAMS_H
+#define PARAMS_H
+
+#include <Arduino.h>
+#include "ramp.h"
+
+// Number of named tuning profiles stored in EEPROM
+static const uint8_t PARAM_PROFILE_COUNT = 3;
+static const uint8_t PARAM_PROFILE_NAME_LEN = 8;
+
+// Drive ramp profiles, one per driving context (see ramp_motors())
+enum RampProfile {
+  RAMP_KID_LAUNCH,             // Pedal pressed or speed raised
+  RAMP_KID_RELEASE,            // Pedal released or speed lowered
+  RAMP_RC,                     // Remote control throttle
+  RAMP_TAKEOVER_SWITCH,        // Stopping to hand over between kid and remote control
+  RAMP_TX_LOSS_STOP,           // Emergency stop on transmitter loss
+  RAMP_PROFILE_COUNT
+};
+
+// Tunable parameters, one set per profile (stored in EEPROM, human units)
+struct TuningParams {
+  uint16_t ramp_up_rate;       // Drive units per second when speeding up
+  uint16_t ramp_dn_rate;       // Drive units per second when slowing down
+  uint16_t jerk_ms;            // Time to build up to full acceleration (0 = linear ramp)
+  uint8_t steer_deadzone;      // Deadzone radius around steering center
+  uint8_t steer_hold_pwm;      // Steering hold PWM after STEER hold time
+  uint16_t steer_hold_ms;      // Time at full steering power before switching to hold
+  uint16_t rx_timeout_ms;      // Receiver signal loss timeout
+  uint16_t rx_min_us;          // Pulse width mapped to 0
+  uint16_t rx_max_us;          // Pulse width mapped to 255
+  uint8_t debounce_ms;         // Onboard input stable time
+  uint16_t park_idle_s;        // Idle time before the parked low-power mode (0 = never)
+};
+
+// Values derived from the active profile, precomputed once for the control loop and ISRs
+struct TuningDerived {
+  RampRates ramp[RAMP_PROFILE_COUNT];
+  uint8_t steer_center_low;    // Below this the stick is left
+  uint8_t steer_center_high;   // At or above this the stick is right
+  uint8_t steer_hold_pwm;
+  uint16_t steer_hold_ms;
+  uint16_t rx_timeout_ms;
+  uint16_t rx_min_us;
+  uint32_t rx_scale_q16;       // 255 / (rx_max_us - rx_min_us) in Q16
+  uint8_t debounce_ms;
+  uint32_t park_idle_ms;       // 0 = never park
+};
+
+// Active tuning, read directly by the control code (written only by the params module)
+extern TuningDerived tuning;
+
+// Load profiles from EEPROM (or defaults if missing/corrupt) and apply the active one
+void setup_params();
+
+// Feed one received serial character to the tuning line parser (line starts with ':')
+// Returns false if the character is not part of a tuning command
+bool params_input(char c);
+
+// Advance a pending :list by at most one line and a pending EEPROM save by at most one byte
+// (call every loop)
+void params_service();
+
+#endif // PARAMS_H
@@ -0,0 +1,51 @@
+#include "power.h"
+#include <avr/io.h>
+#include <avr/power.h>
+#include <avr/sleep.h>
+
+static PowerStats power_stats;
+static unsigned long wake_time_us = 0;
+static bool woke = false;
+
+void setup_power() {
+  // Unused peripherals: TWI, SPI, USART1-3, analog comparator, and Timer3 unless it is
+  // running (setup_motors() leaves it running only for the rear differential)
+  power_twi_disable();
+  power_spi_disable();
+  power_usart1_disable();
+  power_usart2_disable();
+  power_usart3_disable();
+  if (!(TCCR3B & (_BV(CS32) | _BV(CS31) | _BV(CS30)))) power_timer3_disable();
+  ACSR |= _BV(ACD);
+  
+  // Idle keeps timers, external/pin change interrupts, ADC and USART running
+  set_sleep_mode(SLEEP_MODE_IDLE);
+}
+
+void sleep_until_interrupt() {
+  unsigned long start = micros();
+  sleep_enable();
+  sleep_cpu();                     // Any enabled interrupt wakes us up
+  sleep_disable();
+  wake_time_us = micros();
+  woke = true;
+  power_stats.asleep_us += wake_time_us - start;
+  power_stats.sleeps++;
+}
+
+void mark_control_pass() {
+  if (!woke) return;
+  woke = false;
+  unsigned long latency = micros() - wake_time_us;
+  if (latency > 0xFFFF) latency = 0xFFFF;
+  power_stats.last_latency_us = latency;
+  if (latency > power_stats.max_latency_us) power_stats.max_latency_us = latency;
+}
+
+void clear_wake() {
+  woke = false;
+}
+
+void get_power_stats(PowerStats& stats) {
+  stats = power_stats;
+}
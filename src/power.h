@@ -0,0 +1,30 @@
+#ifndef POWER_H
+#define POWER_H
+
+#include <Arduino.h>
+
+// Sleep statistics for the parked mode
+struct PowerStats {
+  unsigned long asleep_us;        // Total time spent sleeping
+  unsigned long sleeps;           // Number of sleep/wake cycles
+  uint16_t last_latency_us;       // Last wake-to-control latency
+  uint16_t max_latency_us;        // Worst wake-to-control latency
+};
+
+// Turn off peripherals the firmware doesn't use
+void setup_power();
+
+// Sleep (idle mode) until the next interrupt: receiver edges, the 1ms Timer0 tick
+// (millis and onboard input sampling), ADC or serial
+void sleep_until_interrupt();
+
+// Record the wake-to-control latency if this control pass follows a wake-up
+void mark_control_pass();
+
+// Forget a wake-up that did not lead to a control pass
+void clear_wake();
+
+// Copy the sleep statistics
+void get_power_stats(PowerStats& stats);
+
+#endif // POWER_H
@@ -0,0 +1,98 @@
+#ifndef RAMP_H
+#define RAMP_H
+
+#include <stdint.h>
+
+// Jerk-limited ramp limits of one RampProfile, in Q16 speed units per ms (and per ms²)
+struct RampRates {
+  int32_t up_q16;              // Max acceleration when speeding up
+  int32_t dn_q16;              // Max acceleration when slowing down
+  int32_t jerk_up_q16;         // Acceleration change per ms when speeding up
+  int32_t jerk_dn_q16;         // Acceleration change per ms when slowing down
+};
+
+// Drive speed ramp state, in Q16 (speed units, speed units per ms). No hardware access, so the
+// same code runs in the native unit tests (test/).
+class SCurveRamp {
+public:
+  SCurveRamp() : current_speed(0), ramp_target(0), accel(0) {}
+
+  // Jerk-limited (S-curve) ramp towards target_speed (-254..254), returns the rounded speed.
+  // The acceleration builds up and eases off at the jerk rate, and starts easing off as soon as
+  // the speed still gained while it does would reach the target (or 0 on a reversal, so the
+  // opposite direction launches from zero acceleration). Constant cost per call.
+  // If we were settled, the loop may have skipped passes: ramp from now, not from the last call.
+  int16_t update(int16_t target_speed, int32_t elapsed_ms, const RampRates& rates) {
+    int32_t target = (int32_t)target_speed << 16;
+    int32_t dt = settled() ? 0 : elapsed_ms;
+    ramp_target = target;
+
+    // A reversal stops at 0 first (eased off like any other stop), then launches from there
+    int32_t goal = target;
+    if ((target > 0 && current_speed < 0) || (target < 0 && current_speed > 0)) goal = 0;
+    int32_t error = goal - current_speed;
+    if (error == 0) {
+      accel = 0;
+      return speed();
+    }
+
+    // Work towards the target: positive error and acceleration point at it
+    bool towards_pos = error > 0;
+    if (!towards_pos) error = -error;
+    int32_t a = towards_pos ? accel : -accel;
+
+    // Speeding up when moving away from 0 (or starting from it), slowing down otherwise
+    bool speeding_up = towards_pos ? current_speed >= 0 : current_speed <= 0;
+    int32_t a_max = speeding_up ? rates.up_q16 : rates.dn_q16;
+    int32_t jerk = speeding_up ? rates.jerk_up_q16 : rates.jerk_dn_q16;
+
+    // Speed gained while easing a down to 0: a² / (2 * jerk), computed on a / 16 to fit 32 bits
+    int32_t a_wanted = a_max;
+    if (a > 0) {
+      uint32_t a16 = (uint32_t)a >> 4;
+      uint32_t ease = a16 * a16 / (uint32_t)jerk;
+      if (ease >= (uint32_t)error >> 7) a_wanted = 0;
+    }
+
+    int32_t step = jerk * dt;
+    if (a < a_wanted) {
+      a = a + step > a_wanted ? a_wanted : a + step;
+    } else if (a > a_wanted) {
+      a = a - step < a_wanted ? a_wanted : a - step;
+    }
+
+    int32_t delta = a * dt;
+    if (delta >= error) {
+      current_speed = goal;                // Arrived, the remaining acceleration is below one jerk step
+      accel = 0;
+    } else {
+      current_speed += towards_pos ? delta : -delta;
+      accel = towards_pos ? a : -a;
+    }
+    return speed();
+  }
+
+  // Ramped speed rounded to -254..254
+  int16_t speed() const {
+    if (current_speed < 0) return -(int16_t)((-current_speed + 0x8000) >> 16);
+    return (int16_t)((current_speed + 0x8000) >> 16);
+  }
+
+  // Jump the ramp to a speed (e.g. restored after a reset), it will ramp from there
+  void set_speed(int16_t speed) {
+    current_speed = (int32_t)speed << 16;
+    accel = 0;
+  }
+
+  // At the target with no acceleration left
+  bool settled() const {
+    return current_speed == ramp_target && accel == 0;
+  }
+
+private:
+  int32_t current_speed;
+  int32_t ramp_target;
+  int32_t accel;
+};
+
+#endif // RAMP_H
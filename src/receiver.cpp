@@ -1,4 +1,5 @@
 #include "receiver.h"
+#include "params.h"
 #include <avr/io.h>
 #include <avr/interrupt.h>
 
@@ -9,8 +10,57 @@ static const uint8_t REVERSE_PIN = 2;        // INT4 - External Interrupt
 static const uint8_t TAKEOVER_PIN = 3;       // INT5 - External Interrupt
 static const uint8_t MAX_THROTTLE_PIN = 18;  // INT3 - External Interrupt
 
-// PWM signal loss detection (configurable timeout)
-static const uint16_t PWM_TIMEOUT_MS = 100;  // Signal loss timeout in milliseconds
+// PWM signal loss timeout and pulse endpoints come from the active tuning profile (params.h)
+
+// Pulses outside this window are counted as out of range (valid servo range is 1100-1900us)
+static const uint16_t RX_VALID_MIN_US = 900;
+static const uint16_t RX_VALID_MAX_US = 2100;
+
+// Pulse width change (vs. last published value) that flags a channel as changed
+static const uint16_t RX_CHANGE_THRESHOLD_US = 2;
+
+// Channels with a changed pulse width since the last take_receiver_changes() (bit per ReceiverChannel)
+volatile uint8_t rx_changed = 0;
+static uint16_t rx_published_us[RX_CHANNEL_COUNT] = {1500, 1500, 1500, 1500, 1500};
+
+// Link health statistics (written by ISRs, copied out with interrupts disabled)
+static ReceiverStats rx_stats[RX_CHANNEL_COUNT];
+
+// Statistics helpers, called from the ISRs
+// Gaps are measured rising edge to rising edge, so a healthy link shows ~one frame period
+static inline void stats_rise(ReceiverStats& stats, uint16_t period_counts, unsigned long now) {
+  stats.period_us = (period_counts + 1) >> 1;
+  if (stats.frames) {                   // No gap to measure before the first pulse
+    unsigned long gap = now - stats.last_edge_ms;
+    if (gap >= tuning.rx_timeout_ms && stats.dropouts < 0xFFFF) stats.dropouts++;
+    if (gap > 0xFFFF) gap = 0xFFFF;
+    if (gap > stats.longest_gap_ms) stats.longest_gap_ms = gap;
+  }
+  stats.last_edge_ms = now;
+}
+
+static inline void stats_pulse(ReceiverStats& stats, uint16_t us, uint16_t prev_us) {
+  if (us < RX_VALID_MIN_US || us > RX_VALID_MAX_US) {
+    if (stats.out_of_range < 0xFFFF) stats.out_of_range++;
+  } else {
+    uint16_t delta = us > prev_us ? us - prev_us : prev_us - us;
+    if (delta > 0x07FF) delta = 0x07FF;
+    // Exponential average over ~16 pulses, Q4
+    int16_t err = (int16_t)(delta << 4) - (int16_t)stats.jitter_q4;
+    stats.jitter_q4 += err / 16;
+  }
+  stats.frames++;
+}
+
+// Flag a channel as changed once its pulse width moves past the threshold, called from the ISRs
+static inline void publish_pulse(uint8_t channel, uint16_t us) {
+  uint16_t last = rx_published_us[channel];
+  uint16_t delta = us > last ? us - last : last - us;
+  if (delta >= RX_CHANGE_THRESHOLD_US) {
+    rx_published_us[channel] = us;
+    rx_changed |= _BV(channel);
+  }
+}
 
 // Steering: Timer5 Input Capture (pin 48)
 volatile uint16_t steering_t_rise = 0;
@@ -38,45 +88,60 @@ volatile uint16_t takeover_us = 1500, max_throttle_us = 1500;
 
 // Timer4 Input Capture ISR (Throttle)
 ISR(TIMER4_CAPT_vect) {
-  throttle_last_activity = millis();    // Update activity timestamp
+  unsigned long now_ms = millis();
+  throttle_last_activity = now_ms;      // Update activity timestamp
   uint16_t t = ICR4;                    // latched timestamp at edge
   if (TCCR4B & _BV(ICES4)) {            // was capturing RISING
+    stats_rise(rx_stats[RX_THROTTLE], (uint16_t)(t - throttle_t_rise), now_ms);
     throttle_t_rise = t;                // remember rising time
     TCCR4B &= ~_BV(ICES4);              // next: capture FALLING
   } else {                              // captured FALLING
     uint16_t counts = (uint16_t)(t - throttle_t_rise); // auto handles wrap
+    uint16_t prev_us = throttle_us;
     throttle_us = (counts + 1) >> 1;    // Convert to microseconds immediately
+    stats_pulse(rx_stats[RX_THROTTLE], throttle_us, prev_us);
+    publish_pulse(RX_THROTTLE, throttle_us);
     TCCR4B |= _BV(ICES4);               // next: capture RISING
   }
 }
 
 // Timer5 Input Capture ISR (Steering)
 ISR(TIMER5_CAPT_vect) {
-  steering_last_activity = millis();    // Update activity timestamp
+  unsigned long now_ms = millis();
+  steering_last_activity = now_ms;      // Update activity timestamp
   uint16_t t = ICR5;                    // latched timestamp at edge
   if (TCCR5B & _BV(ICES5)) {            // was capturing RISING
+    stats_rise(rx_stats[RX_STEERING], (uint16_t)(t - steering_t_rise), now_ms);
     steering_t_rise = t;                // remember rising time
     TCCR5B &= ~_BV(ICES5);              // next: capture FALLING
   } else {                              // captured FALLING
     uint16_t counts = (uint16_t)(t - steering_t_rise); // auto handles wrap
+    uint16_t prev_us = steering_us;
     steering_us = (counts + 1) >> 1;    // Convert to microseconds immediately
+    stats_pulse(rx_stats[RX_STEERING], steering_us, prev_us);
+    publish_pulse(RX_STEERING, steering_us);
     TCCR5B |= _BV(ICES5);               // next: capture RISING
   }
 }
 
 // External interrupt ISR for Reverse (INT4)
 ISR(INT4_vect) {
-  reverse_last_activity = millis();     // Update activity timestamp
+  unsigned long now_ms = millis();
+  reverse_last_activity = now_ms;       // Update activity timestamp
   uint16_t now = TCNT1;                 // Use Timer1 for timestamp
   
   if ((EICRB & (_BV(ISC41) | _BV(ISC40))) == (_BV(ISC41) | _BV(ISC40))) {  // was configured for RISING
+    stats_rise(rx_stats[RX_REVERSE], (uint16_t)(now - reverse_t_rise), now_ms);
     reverse_t_rise = now;
     // Switch to falling edge
     EICRB &= ~(_BV(ISC41) | _BV(ISC40));
     EICRB |= _BV(ISC41);  // falling edge (10)
   } else {                              // was configured for FALLING
     uint16_t counts = (uint16_t)(now - reverse_t_rise);
+    uint16_t prev_us = reverse_us;
     reverse_us = (counts + 1) >> 1;     // Convert to microseconds immediately
+    stats_pulse(rx_stats[RX_REVERSE], reverse_us, prev_us);
+    publish_pulse(RX_REVERSE, reverse_us);
     // Switch back to rising edge
     EICRB &= ~(_BV(ISC41) | _BV(ISC40));
     EICRB |= _BV(ISC41) | _BV(ISC40);  // rising edge (11)
@@ -85,17 +150,22 @@ ISR(INT4_vect) {
 
 // External interrupt ISR for Takeover (INT5) 
 ISR(INT5_vect) {
-  takeover_last_activity = millis();    // Update activity timestamp
+  unsigned long now_ms = millis();
+  takeover_last_activity = now_ms;      // Update activity timestamp
   uint16_t now = TCNT1;                 // Use Timer1 for timestamp
   
   if ((EICRB & (_BV(ISC51) | _BV(ISC50))) == (_BV(ISC51) | _BV(ISC50))) {  // was configured for RISING
+    stats_rise(rx_stats[RX_TAKEOVER], (uint16_t)(now - takeover_t_rise), now_ms);
     takeover_t_rise = now;
     // Switch to falling edge
     EICRB &= ~(_BV(ISC51) | _BV(ISC50));
     EICRB |= _BV(ISC51);  // falling edge (10)
   } else {                              // was configured for FALLING
     uint16_t counts = (uint16_t)(now - takeover_t_rise);
+    uint16_t prev_us = takeover_us;
     takeover_us = (counts + 1) >> 1;    // Convert to microseconds immediately
+    stats_pulse(rx_stats[RX_TAKEOVER], takeover_us, prev_us);
+    publish_pulse(RX_TAKEOVER, takeover_us);
     // Switch back to rising edge  
     EICRB &= ~(_BV(ISC51) | _BV(ISC50));
     EICRB |= _BV(ISC51) | _BV(ISC50);  // rising edge (11)
@@ -104,17 +174,22 @@ ISR(INT5_vect) {
 
 // External interrupt ISR for Max Throttle (INT3) 
 ISR(INT3_vect) {
-  max_throttle_last_activity = millis(); // Update activity timestamp
+  unsigned long now_ms = millis();
+  max_throttle_last_activity = now_ms;  // Update activity timestamp
   uint16_t now = TCNT1;                  // Use Timer1 for timestamp
   
   if ((EICRA & (_BV(ISC31) | _BV(ISC30))) == (_BV(ISC31) | _BV(ISC30))) {  // was configured for RISING
+    stats_rise(rx_stats[RX_MAX_THROTTLE], (uint16_t)(now - max_throttle_t_rise), now_ms);
     max_throttle_t_rise = now;
     // Switch to falling edge
     EICRA &= ~(_BV(ISC31) | _BV(ISC30));
     EICRA |= _BV(ISC31);  // falling edge (10)
   } else {                              // was configured for FALLING
     uint16_t counts = (uint16_t)(now - max_throttle_t_rise);
+    uint16_t prev_us = max_throttle_us;
     max_throttle_us = (counts + 1) >> 1; // Convert to microseconds immediately
+    stats_pulse(rx_stats[RX_MAX_THROTTLE], max_throttle_us, prev_us);
+    publish_pulse(RX_MAX_THROTTLE, max_throttle_us);
     // Switch back to rising edge  
     EICRA &= ~(_BV(ISC31) | _BV(ISC30));
     EICRA |= _BV(ISC31) | _BV(ISC30);  // rising edge (11)
@@ -130,7 +205,7 @@ void setup_receiver() {
   pinMode(MAX_THROTTLE_PIN, INPUT);
   
   // Initialize activity timestamps to expired state (prevents false positives at boot)
-  unsigned long expired = millis() - PWM_TIMEOUT_MS;
+  unsigned long expired = millis() - tuning.rx_timeout_ms;
   steering_last_activity = expired;
   throttle_last_activity = expired;
   reverse_last_activity = expired;
@@ -199,12 +274,14 @@ uint16_t get_raw_takeover() {
   return takeover_us;
 }
 
-// Safe mapping function using Arduino's map() with clamping and optional inversion
-static uint8_t safe_map_to_255(uint16_t pulse_us, uint16_t min_us, uint16_t max_us, bool invert) {
-  long mapped = map((long)pulse_us, min_us, max_us, 0L, 255L);  // Use Arduino's map() for safe arithmetic
+// Map a pulse width to 0-255 using the precomputed endpoints, with clamping and optional inversion
+static uint8_t safe_map_to_255(uint16_t pulse_us, bool invert) {
+  uint32_t mapped = 0;
+  if (pulse_us > tuning.rx_min_us) {
+    mapped = ((uint32_t)(pulse_us - tuning.rx_min_us) * tuning.rx_scale_q16) >> 16;
+  }
   
   // Clamp the result to 0-255 range
-  if (mapped < 0) mapped = 0;
   if (mapped > 255) mapped = 255;
   
   // Apply inversion if requested
@@ -215,11 +292,11 @@ static uint8_t safe_map_to_255(uint16_t pulse_us, uint16_t min_us, uint16_t max_
 
 // Processed data functions
 uint8_t get_steering() {
-  return safe_map_to_255(steering_us, 1100, 1900, false);
+  return safe_map_to_255(steering_us, false);
 }
 
 uint8_t get_throttle() {
-  return safe_map_to_255(throttle_us, 1100, 1900, true);  // Inverted: 1100μs→255, 1900μs→0
+  return safe_map_to_255(throttle_us, true);  // Inverted: rx_min_us→255, rx_max_us→0
 }
 
 bool get_reverse() {
@@ -227,7 +304,7 @@ bool get_reverse() {
 }
 
 uint8_t get_max_throttle() {
-  return safe_map_to_255(max_throttle_us, 1100, 1900, false);
+  return safe_map_to_255(max_throttle_us, false);
 }
 
 bool get_takeover() {
@@ -238,27 +315,59 @@ bool get_takeover() {
 bool is_tx_on() {
   unsigned long now = millis();
   noInterrupts();
-  bool all_active = (now - steering_last_activity) < PWM_TIMEOUT_MS &&
-                    (now - throttle_last_activity) < PWM_TIMEOUT_MS &&
-                    (now - reverse_last_activity) < PWM_TIMEOUT_MS &&
-                    (now - takeover_last_activity) < PWM_TIMEOUT_MS &&
-                    (now - max_throttle_last_activity) < PWM_TIMEOUT_MS;
+  bool all_active = (now - steering_last_activity) < tuning.rx_timeout_ms &&
+                    (now - throttle_last_activity) < tuning.rx_timeout_ms &&
+                    (now - reverse_last_activity) < tuning.rx_timeout_ms &&
+                    (now - takeover_last_activity) < tuning.rx_timeout_ms &&
+                    (now - max_throttle_last_activity) < tuning.rx_timeout_ms;
   
   // Refresh individual timestamps when inactive to handle millis() rollover
   if (!all_active) {
-    unsigned long expired = now - PWM_TIMEOUT_MS;
-    if ((now - steering_last_activity) >= PWM_TIMEOUT_MS)
+    unsigned long expired = now - tuning.rx_timeout_ms;
+    if ((now - steering_last_activity) >= tuning.rx_timeout_ms)
       steering_last_activity = expired;
-    if ((now - throttle_last_activity) >= PWM_TIMEOUT_MS)
+    if ((now - throttle_last_activity) >= tuning.rx_timeout_ms)
       throttle_last_activity = expired;
-    if ((now - reverse_last_activity) >= PWM_TIMEOUT_MS)
+    if ((now - reverse_last_activity) >= tuning.rx_timeout_ms)
       reverse_last_activity = expired;
-    if ((now - takeover_last_activity) >= PWM_TIMEOUT_MS)
+    if ((now - takeover_last_activity) >= tuning.rx_timeout_ms)
       takeover_last_activity = expired;
-    if ((now - max_throttle_last_activity) >= PWM_TIMEOUT_MS)
+    if ((now - max_throttle_last_activity) >= tuning.rx_timeout_ms)
       max_throttle_last_activity = expired;
   }
   interrupts();
   return all_active;
 }
 
+// Changed channels since the last call (bit per ReceiverChannel), clears the flags
+uint8_t take_receiver_changes() {
+  noInterrupts();
+  uint8_t changes = rx_changed;
+  rx_changed = 0;
+  interrupts();
+  return changes;
+}
+
+// Link health statistics
+void get_receiver_stats(uint8_t channel, ReceiverStats& stats) {
+  if (channel >= RX_CHANNEL_COUNT) return;
+  noInterrupts();
+  stats = rx_stats[channel];
+  interrupts();
+
+  // A gap still in progress only reaches the ISR statistics when the signal comes back:
+  // include it here so a dropout shows up while it is happening
+  if (!stats.frames) return;
+  unsigned long gap = millis() - stats.last_edge_ms;
+  if (gap >= tuning.rx_timeout_ms && stats.dropouts < 0xFFFF) stats.dropouts++;
+  if (gap > 0xFFFF) gap = 0xFFFF;
+  if (gap > stats.longest_gap_ms) stats.longest_gap_ms = gap;
+}
+
+void reset_receiver_stats() {
+  noInterrupts();
+  for (uint8_t i = 0; i < RX_CHANNEL_COUNT; i++) {
+    rx_stats[i] = ReceiverStats();
+  }
+  interrupts();
+}
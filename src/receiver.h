@@ -3,6 +3,27 @@
 
 #include <Arduino.h>
 
+// Receiver channels, in the order used by the statistics API
+enum ReceiverChannel {
+  RX_STEERING,      // CH1
+  RX_THROTTLE,      // CH3
+  RX_REVERSE,       // CH5
+  RX_MAX_THROTTLE,  // CH6
+  RX_TAKEOVER,      // CH7
+  RX_CHANNEL_COUNT
+};
+
+// Per-channel link health, accumulated by the ISRs
+struct ReceiverStats {
+  unsigned long frames;           // Complete pulses received
+  uint16_t period_us;             // Last measured frame period (rising edge to rising edge)
+  uint16_t jitter_q4;             // Filtered pulse-to-pulse width change, us in Q4
+  uint16_t out_of_range;          // Pulses outside the valid servo range
+  uint16_t dropouts;              // Gaps of at least the signal loss timeout (incl. one in progress)
+  uint16_t longest_gap_ms;        // Longest gap between rising edges (incl. one in progress)
+  unsigned long last_edge_ms;     // millis() of the last rising edge
+};
+
 // Initialize the 5-channel PWM receiver system
 void setup_receiver();
 
@@ -14,14 +35,21 @@ uint16_t get_raw_max_throttle();// Pin 18 - CH6 analog
 uint16_t get_raw_takeover();    // Pin 3  - CH7 digital
 
 // Processed data functions
-uint8_t get_steering();         // 0-255 (1100-1900us mapped)
-uint8_t get_throttle();         // 0-255 (1100-1900us mapped, inverted)
+uint8_t get_steering();         // 0-255 (rx_min_us-rx_max_us mapped, default 1100-1900us)
+uint8_t get_throttle();         // 0-255 (rx_min_us-rx_max_us mapped, inverted)
 bool get_reverse();             // true if >1500us, false if <=1500us
-uint8_t get_max_throttle();     // 0-255 (1100-1900us mapped)
+uint8_t get_max_throttle();     // 0-255 (rx_min_us-rx_max_us mapped)
 bool get_takeover();            // true if <1600us (RC mode), false if >=1600us (kids mode)
 
 // TX status - returns true only if ALL channels are active
 bool is_tx_on();
 
+// Channels whose pulse width changed since the last call (bit per ReceiverChannel)
+uint8_t take_receiver_changes();
+
+// Link health statistics
+void get_receiver_stats(uint8_t channel, ReceiverStats& stats);
+void reset_receiver_stats();
+
 #endif // RECEIVER_H
 
@@ -0,0 +1,46 @@
+#ifndef STEER_COUPLING_H
+#define STEER_COUPLING_H
+
+#include <stdint.h>
+#ifdef ARDUINO
+#include <avr/pgmspace.h>
+#else
+// Native unit tests (test/): curves live in RAM
+#define PROGMEM
+#define pgm_read_byte(p) (*(const uint8_t*)(p))
+#endif
+
+// Speed/steering coupling curves, 9 points (0, 32, ... 256) interpolated linearly
+// Steering burst PWM at full stick by |ramped speed|: slower turn-in at speed
+// (254 max, driver doesn't handle 255)
+static const uint8_t STEER_BURST_PWM_CURVE[9] PROGMEM = {
+  254, 254, 240, 220, 200, 182, 166, 152, 140
+};
+// Drive target limit by |stick - 128| * 2 (full lock either way = 256): slow down for hard steering
+static const uint8_t CORNER_SPEED_LIMIT_CURVE[9] PROGMEM = {
+  254, 254, 254, 254, 254, 228, 200, 175, 150
+};
+
+// Piecewise linear lookup of a 9 point curve at x (0-255)
+inline uint8_t curve_lookup(const uint8_t* curve, uint8_t x) {
+  uint8_t i = x >> 5;
+  int16_t y0 = pgm_read_byte(&curve[i]);
+  int16_t y1 = pgm_read_byte(&curve[i + 1]);
+  return y0 + (((y1 - y0) * (x & 31)) >> 5);
+}
+
+// Full stick steering burst PWM at a ramped speed (-254..254)
+inline uint8_t steer_burst_pwm(int16_t speed) {
+  return curve_lookup(STEER_BURST_PWM_CURVE, speed < 0 ? -speed : speed);
+}
+
+// Cap a drive target to the cornering speed limit of a steering stick position (0-255)
+inline int16_t limit_corner_speed(int16_t target_speed, uint8_t stick) {
+  uint8_t offset = stick >= 128 ? stick - 128 : 128 - stick;
+  int16_t limit = curve_lookup(CORNER_SPEED_LIMIT_CURVE, offset >= 127 ? 255 : offset * 2);
+  if (target_speed < -limit) return -limit;
+  if (target_speed > limit) return limit;
+  return target_speed;
+}
+
+#endif // STEER_COUPLING_H
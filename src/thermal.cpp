@@ -0,0 +1,48 @@
+#include "thermal.h"
+
+// Drive level the 100A driver can sustain indefinitely (~500W continuous, see doc/driver.md)
+static const uint8_t THERMAL_CONT_LEVEL = 160;
+
+// Full budget = 2^31 level²·ms above continuous: ~55s at 254 starting from cold.
+// Budget level in Q8 is then simply accumulator >> 23.
+static const uint32_t THERMAL_BUDGET = 0x80000000UL;
+static const uint8_t THERMAL_LEVEL_SHIFT = 23;
+
+// Derating starts at half budget and reaches THERMAL_CONT_LEVEL at full budget
+static const uint16_t THERMAL_DERATE_START = 128;
+
+// Clamp for elapsed time so a stalled loop doesn't inject a huge step
+static const unsigned long THERMAL_MAX_STEP_MS = 100;
+
+// Heat above continuous rating, in level²·ms (0 = cold)
+static uint32_t thermal_acc = 0;
+
+void update_thermal(uint8_t drive_level, unsigned long elapsed_ms) {
+  if (elapsed_ms > THERMAL_MAX_STEP_MS) elapsed_ms = THERMAL_MAX_STEP_MS;
+
+  // I²t: heating above the continuous rating, cooling below it
+  int32_t power = (int32_t)drive_level * drive_level -
+                  (int32_t)THERMAL_CONT_LEVEL * THERMAL_CONT_LEVEL;
+  int32_t delta = power * (int32_t)elapsed_ms;
+
+  if (delta >= 0) {
+    if (THERMAL_BUDGET - thermal_acc < (uint32_t)delta) thermal_acc = THERMAL_BUDGET;
+    else thermal_acc += delta;
+  } else {
+    if (thermal_acc < (uint32_t)-delta) thermal_acc = 0;
+    else thermal_acc -= (uint32_t)-delta;
+  }
+}
+
+uint16_t get_thermal_level() {
+  return (uint16_t)(thermal_acc >> THERMAL_LEVEL_SHIFT);
+}
+
+uint8_t get_thermal_limit() {
+  uint16_t level = get_thermal_level();
+  if (level <= THERMAL_DERATE_START) return 254;
+
+  // Linear derate from 254 down to the continuous level (shift by 7 = divide by 256-128)
+  uint16_t over = level - THERMAL_DERATE_START;
+  return 254 - (uint8_t)(((uint16_t)(254 - THERMAL_CONT_LEVEL) * over) >> 7);
+}
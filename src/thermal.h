@@ -0,0 +1,15 @@
+#ifndef THERMAL_H
+#define THERMAL_H
+
+#include <Arduino.h>
+
+// Advance the driver thermal model by elapsed_ms at the given drive level (0-254)
+void update_thermal(uint8_t drive_level, unsigned long elapsed_ms);
+
+// Max drive target magnitude allowed by the thermal model (254 = no derating)
+uint8_t get_thermal_limit();
+
+// Used thermal budget, 0 (cold) to 256 (exhausted)
+uint16_t get_thermal_level();
+
+#endif // THERMAL_H
@@ -0,0 +1,127 @@
+#include "warmboot.h"
+#include <avr/io.h>
+#include <avr/wdt.h>
+#include <avr/interrupt.h>
+#include <stddef.h>
+
+// Control state preserved across resets in .noinit RAM (not cleared by the C runtime)
+struct WarmState {
+  uint16_t magic;
+  uint8_t mode;
+  int16_t ramped_speed;
+  unsigned long uptime_ms;
+  uint16_t counts[RESET_CAUSE_COUNT];
+  uint8_t wdt_marker;                        // WDT_MARKER once the watchdog interrupt fired
+  uint16_t checksum;
+};
+
+static const uint16_t WARM_STATE_MAGIC = 0x5A18;   // Bump when WarmState layout changes
+static const uint8_t WDT_MARKER = 0xA5;
+
+static WarmState warm_state __attribute__((section(".noinit")));
+
+// MCUSR captured before it is cleared in .init3
+static uint8_t reset_flags __attribute__((section(".noinit")));
+
+static ResetInfo reset_info;
+
+// Save the reset cause and disable watchdog at boot to prevent reset loop
+void wdt_init(void) __attribute__((naked)) __attribute__((used)) __attribute__((section(".init3")));
+void wdt_init(void) {
+  reset_flags = MCUSR;
+  MCUSR = 0;
+  wdt_disable();
+}
+
+// Fletcher-16 over everything but the checksum itself
+static uint16_t warm_state_checksum() {
+  const uint8_t* p = (const uint8_t*)&warm_state;
+  uint8_t sum1 = 0, sum2 = 0;
+  for (uint8_t i = 0; i < offsetof(WarmState, checksum); i++) {
+    sum1 += p[i];
+    sum2 += sum1;
+  }
+  return ((uint16_t)sum2 << 8) | sum1;
+}
+
+// The Mega bootloader runs first after a watchdog reset and clears MCUSR itself, so WDRF is
+// usually lost: a watchdog reset is recognized by the marker WDT_vect left in warm_state
+static ResetCause classify_reset(uint8_t flags, bool wdt_marked) {
+  if (flags & _BV(PORF)) return RESET_POWER_ON;
+  if (flags & _BV(BORF)) return RESET_BROWN_OUT;
+  if (wdt_marked || (flags & _BV(WDRF))) return RESET_WATCHDOG;
+  if (flags & _BV(EXTRF)) return RESET_EXTERNAL;
+  if (flags & _BV(JTRF)) return RESET_JTAG;
+  return RESET_EXTERNAL;                     // No flag: bootloader jump, treat as external
+}
+
+// Watchdog interrupt: fires one timeout before the watchdog reset (interrupt + reset mode),
+// mark the coming reset as ours. The loop is stuck, so nothing else is writing warm_state.
+ISR(WDT_vect) {
+  warm_state.wdt_marker = WDT_MARKER;
+  warm_state.checksum = warm_state_checksum();
+}
+
+bool setup_warmboot() {
+  bool valid = warm_state.magic == WARM_STATE_MAGIC &&
+               warm_state.checksum == warm_state_checksum();
+  reset_info.cause = classify_reset(reset_flags, valid && warm_state.wdt_marker == WDT_MARKER);
+  warm_state.wdt_marker = 0;
+
+  // Power loss leaves RAM undefined, start counting from scratch
+  if (!valid || reset_info.cause == RESET_POWER_ON) {
+    memset(&warm_state, 0, sizeof(warm_state));
+    warm_state.magic = WARM_STATE_MAGIC;
+  }
+
+  if (warm_state.counts[reset_info.cause] < 0xFFFF) warm_state.counts[reset_info.cause]++;
+
+  memcpy(reset_info.counts, warm_state.counts, sizeof(reset_info.counts));
+  reset_info.warm = valid && reset_info.cause == RESET_WATCHDOG;
+  reset_info.prev_mode = warm_state.mode;
+  reset_info.prev_speed = valid ? warm_state.ramped_speed : 0;
+  reset_info.prev_uptime_ms = warm_state.uptime_ms;
+
+  warm_state.checksum = warm_state_checksum();
+  return reset_info.warm;
+}
+
+void save_warm_state(uint8_t mode, int16_t ramped_speed) {
+  unsigned long now = millis();
+
+  // WDT_vect also updates the block, keep the checksum consistent with its marker
+  noInterrupts();
+  warm_state.mode = mode;
+  warm_state.ramped_speed = ramped_speed;
+  warm_state.uptime_ms = now;
+  warm_state.checksum = warm_state_checksum();
+  interrupts();
+}
+
+void setup_watchdog() {
+  // Interrupt + reset mode, 250ms: WDT_vect marks the reset at 250ms without a pet,
+  // the reset follows at the next timeout (500ms total, as before)
+  noInterrupts();
+  wdt_reset();
+  WDTCSR = _BV(WDCE) | _BV(WDE);
+  WDTCSR = _BV(WDIE) | _BV(WDE) | _BV(WDP2);
+  interrupts();
+}
+
+void pet_watchdog() {
+  wdt_reset();
+
+  // The hardware clears WDIE when the interrupt fires: the loop was late but recovered,
+  // so drop the marker and re-arm the interrupt (WDIE needs no timed sequence)
+  if (!(WDTCSR & _BV(WDIE))) {
+    noInterrupts();
+    warm_state.wdt_marker = 0;
+    warm_state.checksum = warm_state_checksum();
+    WDTCSR |= _BV(WDIE);
+    interrupts();
+  }
+}
+
+const ResetInfo& get_reset_info() {
+  return reset_info;
+}
@@ -0,0 +1,41 @@
+#ifndef WARMBOOT_H
+#define WARMBOOT_H
+
+#include <Arduino.h>
+
+// Reset causes, in the order they are counted
+enum ResetCause {
+  RESET_POWER_ON,
+  RESET_EXTERNAL,
+  RESET_BROWN_OUT,
+  RESET_WATCHDOG,
+  RESET_JTAG,
+  RESET_CAUSE_COUNT
+};
+
+// What we know about the last reset and the state it interrupted
+struct ResetInfo {
+  ResetCause cause;                          // Cause of the last reset
+  uint16_t counts[RESET_CAUSE_COUNT];        // Resets by cause since last power-on
+  bool warm;                                 // Control state was restored
+  uint8_t prev_mode;                         // ControlMode before the reset
+  int16_t prev_speed;                        // Ramped speed before the reset
+  unsigned long prev_uptime_ms;              // millis() at the last save before the reset
+};
+
+// Classify the reset and validate the preserved state, returns true on a warm boot
+bool setup_warmboot();
+
+// Start the watchdog (500ms, marks its own resets so they are recognized after the bootloader)
+void setup_watchdog();
+
+// Pet the watchdog (call every loop instead of wdt_reset())
+void pet_watchdog();
+
+// Preserve control state so it survives a watchdog reset (call every loop)
+void save_warm_state(uint8_t mode, int16_t ramped_speed);
+
+// Last reset cause, counters and restored state
+const ResetInfo& get_reset_info();
+
+#endif // WARMBOOT_H
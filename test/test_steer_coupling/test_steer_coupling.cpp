@@ -0,0 +1,165 @@
+// Steering/speed coupling and drive ramp, run on the host: pio test -e native
+#ifdef ARDUINO
+#include <Arduino.h>
+#endif
+#include <unity.h>
+#include "ramp.h"
+#include "steer_coupling.h"
+
+// Control pass interval used by the scripted manoeuvres (CONTROL_MAX_INTERVAL_MS)
+static const int32_t TICK_MS = 20;
+
+// RAMP_RC limits of the default "kid" profile (ramp_up 51, ramp_dn 255, jerk_ms 400 / 2),
+// computed as in params.cpp
+static RampRates rc_rates() {
+  RampRates r;
+  r.up_q16 = ((int32_t)51 * 256 << 8) / 1000;
+  r.dn_q16 = ((int32_t)255 * 256 << 8) / 1000;
+  r.jerk_up_q16 = r.up_q16 / 200;
+  r.jerk_dn_q16 = r.dn_q16 / 200;
+  return r;
+}
+
+// One control pass as in ramp_motors(): cornering cap, then the ramp
+static int16_t drive_pass(SCurveRamp& ramp, int16_t target, uint8_t stick) {
+  return ramp.update(limit_corner_speed(target, stick), TICK_MS, rc_rates());
+}
+
+// Drive straight until the ramp settles at target
+static void settle(SCurveRamp& ramp, int16_t target) {
+  for (int i = 0; i < 1000 && (ramp.speed() != target || !ramp.settled()); i++) {
+    drive_pass(ramp, target, 128);
+  }
+  TEST_ASSERT_EQUAL_INT16(target, ramp.speed());
+}
+
+void setUp() {}
+void tearDown() {}
+
+void test_curve_lookup_hits_points() {
+  for (uint8_t i = 0; i < 8; i++) {
+    TEST_ASSERT_EQUAL_UINT8(STEER_BURST_PWM_CURVE[i], curve_lookup(STEER_BURST_PWM_CURVE, i * 32));
+    TEST_ASSERT_EQUAL_UINT8(CORNER_SPEED_LIMIT_CURVE[i],
+                            curve_lookup(CORNER_SPEED_LIMIT_CURVE, i * 32));
+  }
+  // Last point is reached at x = 256, 255 is one step short
+  TEST_ASSERT_EQUAL_UINT8(140, curve_lookup(STEER_BURST_PWM_CURVE, 255));
+  TEST_ASSERT_EQUAL_UINT8(150, curve_lookup(CORNER_SPEED_LIMIT_CURVE, 255));
+}
+
+void test_curve_lookup_interpolates() {
+  TEST_ASSERT_EQUAL_UINT8(247, curve_lookup(STEER_BURST_PWM_CURVE, 48));    // 254 -> 240
+  TEST_ASSERT_EQUAL_UINT8(241, curve_lookup(CORNER_SPEED_LIMIT_CURVE, 144)); // 254 -> 228
+}
+
+void test_burst_pwm_falls_with_speed() {
+  TEST_ASSERT_EQUAL_UINT8(254, steer_burst_pwm(0));
+  TEST_ASSERT_EQUAL_UINT8(140, steer_burst_pwm(254));
+  for (int16_t speed = 1; speed <= 254; speed++) {
+    TEST_ASSERT_TRUE(steer_burst_pwm(speed) <= steer_burst_pwm(speed - 1));
+    TEST_ASSERT_EQUAL_UINT8(steer_burst_pwm(speed), steer_burst_pwm(-speed));
+  }
+}
+
+void test_corner_limit() {
+  // Center and up to half stick: no cap
+  TEST_ASSERT_EQUAL_INT16(254, limit_corner_speed(254, 128));
+  TEST_ASSERT_EQUAL_INT16(254, limit_corner_speed(254, 128 + 64));
+  TEST_ASSERT_EQUAL_INT16(-254, limit_corner_speed(-254, 128 - 64));
+
+  // Full lock either way, forward and reverse
+  TEST_ASSERT_EQUAL_INT16(150, limit_corner_speed(254, 255));
+  TEST_ASSERT_EQUAL_INT16(150, limit_corner_speed(254, 0));
+  TEST_ASSERT_EQUAL_INT16(-150, limit_corner_speed(-254, 255));
+
+  // Slow targets pass through
+  TEST_ASSERT_EQUAL_INT16(100, limit_corner_speed(100, 255));
+  TEST_ASSERT_EQUAL_INT16(0, limit_corner_speed(0, 0));
+}
+
+// Full speed straight, then a hard right turn: slow down smoothly to the cap, turn in gently
+void test_turn_in_at_full_speed() {
+  SCurveRamp ramp;
+  settle(ramp, 254);
+  uint8_t burst_at_speed = steer_burst_pwm(ramp.speed());
+  TEST_ASSERT_TRUE(burst_at_speed < steer_burst_pwm(0));
+
+  int16_t prev = ramp.speed();
+  int32_t t = 0;
+  while (ramp.speed() != 150 || !ramp.settled()) {
+    int16_t speed = drive_pass(ramp, 254, 255);
+    TEST_ASSERT_TRUE(speed <= prev);              // Monotonic, no overshoot below the cap
+    TEST_ASSERT_TRUE(speed >= 150);
+    TEST_ASSERT_TRUE(prev - speed <= 6);          // At most ramp_dn (255/s) per pass, rounded
+    prev = speed;
+    t += TICK_MS;
+    TEST_ASSERT_TRUE(t <= 1000);                  // 104 units at 255/s plus the jerk build-up
+  }
+  TEST_ASSERT_TRUE(t >= 400);                     // Not faster than ramp_dn allows
+
+  // Burst power recovers as the car slows
+  TEST_ASSERT_TRUE(steer_burst_pwm(ramp.speed()) > burst_at_speed);
+}
+
+// Stick back to center after the turn: speed up again at the launch rate
+void test_speed_recovers_after_turn() {
+  SCurveRamp ramp;
+  settle(ramp, 254);
+  for (int i = 0; i < 100; i++) drive_pass(ramp, 254, 0);
+  TEST_ASSERT_EQUAL_INT16(150, ramp.speed());
+
+  int16_t prev = ramp.speed();
+  int32_t t = 0;
+  while (ramp.speed() != 254 || !ramp.settled()) {
+    int16_t speed = drive_pass(ramp, 254, 128);
+    TEST_ASSERT_TRUE(speed >= prev && speed <= 254);
+    TEST_ASSERT_TRUE(speed - prev <= 2);          // At most ramp_up (51/s) per pass, rounded
+    prev = speed;
+    t += TICK_MS;
+    TEST_ASSERT_TRUE(t <= 3000);
+  }
+  TEST_ASSERT_TRUE(t >= 2000);                    // 104 units at 51/s
+}
+
+// Direct reversal: brake to 0, then launch in reverse at the launch rate, not the braking rate
+void test_reversal_launches_from_zero() {
+  SCurveRamp ramp;
+  settle(ramp, 200);
+
+  int32_t t = 0, t_zero = -1, t_half = -1;
+  while (t_half < 0) {
+    int16_t speed = drive_pass(ramp, -254, 128);
+    t += TICK_MS;
+    if (speed == 0 && t_zero < 0) t_zero = t;
+    if (speed <= -127) t_half = t;
+    TEST_ASSERT_TRUE(t <= 10000);
+  }
+  TEST_ASSERT_TRUE(t_zero > 0);
+  TEST_ASSERT_TRUE(t_half - t_zero >= 2400);      // 127 units at 51/s is ~2.5s
+}
+
+static void run_tests() {
+  UNITY_BEGIN();
+  RUN_TEST(test_curve_lookup_hits_points);
+  RUN_TEST(test_curve_lookup_interpolates);
+  RUN_TEST(test_burst_pwm_falls_with_speed);
+  RUN_TEST(test_corner_limit);
+  RUN_TEST(test_turn_in_at_full_speed);
+  RUN_TEST(test_speed_recovers_after_turn);
+  RUN_TEST(test_reversal_launches_from_zero);
+  UNITY_END();
+}
+
+#ifdef ARDUINO
+void setup() {
+  delay(2000);                                    // Let the board's serial monitor attach
+  run_tests();
+}
+
+void loop() {}
+#else
+int main() {
+  run_tests();
+  return 0;
+}
+#endif